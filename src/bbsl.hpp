@@ -9,7 +9,25 @@
 #include <cstdint>
 #include <algorithm>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <new>
+#include <utility>
+#include <iterator>
+#include <cassert>
+#include <cstring>
+#include <istream>
+#include <ostream>
 #include <memory_resource>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <exception>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
 
 #include "./bits.hpp"
 #include "./slab.hpp"
@@ -53,21 +71,326 @@ namespace bbsl {
 		}
 	};
 
-	using bitMap_t = uint16_t;
-	constexpr uint64_t capacity_count = sizeof(bitMap_t) * 8;
-	constexpr uint64_t index_align = (capacity_count - 1); // Align to capacity limit
+	constexpr uint8_t max_level = 32;		// level is limited to [0-31]
+	constexpr uint8_t inline_levels = 4;	// about 15/16 of the nodes never leave the inline tower
+	constexpr size_t cache_line_size = 64;
+
+	static inline void prefetch(const void* address) noexcept {
+#if defined(__clang__) || defined(__GNUC__)
+		__builtin_prefetch(address, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		_mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+		(void)address;
+#endif
+	}
+
+	/**
+	 * @brief the binary layout written by BitmappedBlockSkipList::serialize
+	 * FileHeader, then blockCount records in baseIndex order, each a BlockHeader followed by popcnt(bitMap) packed elements
+	 * (a full block is simply all of them), then the directory: blockCount bases and blockCount record offsets
+	 * every part starts on 8 bytes and integers are in host byte order, endian_tag tells a foreign file apart
+	 */
+	namespace format {
+		constexpr char magic[8] = { 'B', 'B', 'S', 'L', 'B', 'L', 'K', '\0' };
+		constexpr uint32_t version = 1;
+		constexpr uint64_t endian_tag = 0x0102030405060708ULL;
+
+		struct FileHeader {
+			char magic[8];
+			uint64_t endianTag;
+			uint32_t version;
+			uint32_t valueBytes;
+			uint8_t indexBytes;
+			uint8_t bitMapBytes;
+			uint8_t indexSigned;
+			uint8_t reserved[5];
+			uint64_t blockCount;
+			uint64_t elementCount;
+			uint64_t directoryOffset;	// from the start of the file
+			uint64_t fileBytes;
+		};
+
+		struct BlockHeader {
+			uint64_t baseIndex;			// sign extended for a signed index_t
+			uint64_t bitMap;
+		};
+
+		static_assert(sizeof(FileHeader) == 64 && sizeof(BlockHeader) == 16, "the header layout is part of the format");
+
+		static inline uint64_t padded(const uint64_t bytes) {
+			return (bytes + 7) & ~static_cast<uint64_t>(7);
+		}
+
+		static inline uint64_t recordBytes(const uint64_t elements, const uint64_t valueBytes) {
+			return sizeof(BlockHeader) + padded(elements * valueBytes);
+		}
+
+		// the directory can be binary searched in the order of index_t
+		template<typename index_t>
+		using wide_index_t = std::conditional_t<std::is_signed_v<index_t>, int64_t, uint64_t>;
+
+		template<typename index_t>
+		static inline uint64_t encodeIndex(const index_t index) {
+			return static_cast<uint64_t>(static_cast<wide_index_t<index_t>>(index));
+		}
+
+		template<typename index_t>
+		static inline index_t decodeIndex(const uint64_t word) {
+			return static_cast<index_t>(static_cast<wide_index_t<index_t>>(word));
+		}
+
+		template<typename index_t, typename value_t, typename bitMap_t>
+		static FileHeader makeHeader(const uint64_t blockCount, const uint64_t elementCount, const uint64_t directoryOffset) {
+			FileHeader header = {};
+			std::memcpy(header.magic, format::magic, sizeof(header.magic));
+			header.endianTag = format::endian_tag;
+			header.version = format::version;
+			header.valueBytes = sizeof(value_t);
+			header.indexBytes = sizeof(index_t);
+			header.bitMapBytes = sizeof(bitMap_t);
+			header.indexSigned = std::is_signed_v<index_t> ? 1 : 0;
+			header.blockCount = blockCount;
+			header.elementCount = elementCount;
+			header.directoryOffset = directoryOffset;
+			header.fileBytes = directoryOffset + blockCount * sizeof(uint64_t) * 2;
+			return header;
+		}
+
+		/**
+		 * @brief the file was written on a machine of the same byte order by a list of the same template arguments
+		 */
+		template<typename index_t, typename value_t, typename bitMap_t>
+		static bool compatible(const FileHeader& header) {
+			return std::memcmp(header.magic, format::magic, sizeof(header.magic)) == 0
+				&& header.endianTag == format::endian_tag && header.version == format::version
+				&& header.valueBytes == sizeof(value_t) && header.indexBytes == sizeof(index_t) && header.bitMapBytes == sizeof(bitMap_t)
+				&& header.indexSigned == (std::is_signed_v<index_t> ? 1 : 0)
+				&& header.directoryOffset >= sizeof(FileHeader) && (header.directoryOffset & 7) == 0
+				// the directory holds two words per block, bounded by the file size first so a corrupt count cannot overflow
+				&& header.directoryOffset <= header.fileBytes
+				&& header.blockCount <= (header.fileBytes - header.directoryOffset) / (sizeof(uint64_t) * 2)
+				&& header.fileBytes - header.directoryOffset == header.blockCount * sizeof(uint64_t) * 2;
+		}
+	}
+
+	// stands in for a node field that an option turns off, it only takes a padding byte
+	struct NoStamp {};
+
+	/**
+	 * @brief the element slots of a block for a value_t that is not trivial, only the slots under the bitmap hold an object
+	 * raw storage keeps the node trivially destructible, the list constructs and destroys the slots as the bits go
+	 */
+	template <typename value_t, size_t count>
+	struct RawSlots {
+		alignas(value_t) unsigned char bytes[sizeof(value_t) * count];
+
+		// the address of slot i, for placement new
+		void* at(const size_t i) {
+			return this->bytes + i * sizeof(value_t);
+		}
+
+		value_t& operator[](const size_t i) {
+			return *std::launder(reinterpret_cast<value_t*>(this->bytes + i * sizeof(value_t)));
+		}
+
+		const value_t& operator[](const size_t i) const {
+			return *std::launder(reinterpret_cast<const value_t*>(this->bytes + i * sizeof(value_t)));
+		}
+
+		// for block callbacks, only the slots under the bitmap may be read
+		operator value_t* () {
+			return std::launder(reinterpret_cast<value_t*>(this->bytes));
+		}
+
+		operator const value_t* () const {
+			return std::launder(reinterpret_cast<const value_t*>(this->bytes));
+		}
+	};
+
+	/**
+	 * @brief runs the workers of a parallel traversal on fresh threads, the calling thread is worker 0
+	 * any type with the same two members plugs in, e.g. to reuse the threads of a pool
+	 */
+	struct ThreadExecutor {
+		uint32_t threads = 0;	// 0 means std::thread::hardware_concurrency()
+
+		uint32_t concurrency() const {
+			const uint32_t hardware = std::thread::hardware_concurrency();
+			return (this->threads != 0) ? this->threads : ((hardware != 0) ? hardware : 1);
+		}
+
+		/**
+		 * @brief call job(worker) for every worker in [0, workers) concurrently and return when all are done
+		 * the first exception of a worker, or of starting a thread, is rethrown once every started thread is joined
+		 */
+		template<typename Job>
+		void run(const uint32_t workers, Job& job) const {
+			if (workers <= 1) {
+				job(0);
+				return;
+			}
+
+			std::exception_ptr failure;
+			std::mutex lock;
+			const auto guarded = [&job, &failure, &lock](const uint32_t w) {
+				try {
+					job(w);
+				}
+				catch (...) {
+					std::lock_guard<std::mutex> guard(lock);
+					if (failure == nullptr) failure = std::current_exception();
+				}
+				};
+
+			std::vector<std::thread> spawned;
+			{
+				// joins what was started on every way out, a joinable thread must never be destroyed
+				struct Joiner {
+					std::vector<std::thread>& threads;
+					~Joiner() {
+						for (std::thread& thread : this->threads) thread.join();
+					}
+				} joiner{ spawned };
+
+				spawned.reserve(workers - 1);
+				for (uint32_t w = 1; w < workers; ++w) spawned.emplace_back(guarded, w);
+				guarded(0);
+			}
+			if (failure != nullptr) std::rethrow_exception(failure);
+		}
+	};
+
+	/**
+	 * @brief every worker on the calling thread, one after the other
+	 */
+	struct InlineExecutor {
+		uint32_t concurrency() const {
+			return 1;
+		}
+
+		template<typename Job>
+		void run(const uint32_t workers, Job& job) const {
+			for (uint32_t w = 0; w < workers; ++w) job(w);
+		}
+	};
+
+	/**
+	 * @brief compile-time tuning knobs, derive from it and override what you need
+	 * struct MyOptions : bbsl::DefaultOptions { static constexpr uint8_t prefetch_distance = 8; };
+	 */
+	struct DefaultOptions {
+		// level 0 scans prefetch the node this many hops ahead, 0 disables it
+		static constexpr uint8_t prefetch_distance = 0;
+		// descents prefetch both candidates of the next step (right at this level and right at the level below)
+		static constexpr bool prefetch_descent = false;
+		// compact() promotes runs of at least this many consecutive full blocks into one extent, 0 disables it
+		static constexpr uint16_t extent_blocks = 0;
+		// direct-mapped cache from index / capacity_count to its block in front of the descent, a power of 2, 0 disables it
+		static constexpr uint32_t index_cache_slots = 0;
+		// count descents, finger hits, level changes and node traffic, the counting code is compiled out otherwise
+		// counted const lookups write the counters, so readers on several threads need it disabled
+		static constexpr bool collect_counters = false;
+		// tower heights come from the block number (ctz of baseIndex / capacity_count) instead of coin flips,
+		// a perfect skip list for dense arrays, but keys strided by a power of 2 blocks get uneven towers
+		static constexpr bool indexed_levels = false;
+		// snapshot() shares the blocks with the list, a write copies a shared block first, extents are not used then
+		static constexpr bool snapshots = false;
+		// every tower link counts the elements it skips, so rank() and nth() take one descent, a write pays O(log n) to keep them
+		static constexpr bool order_statistics = false;
+	};
+
+	struct PrefetchOptions : DefaultOptions {
+		static constexpr uint8_t prefetch_distance = 4;
+		static constexpr bool prefetch_descent = true;
+	};
+
+	struct IndexCacheOptions : DefaultOptions {
+		static constexpr uint32_t index_cache_slots = 4096;
+	};
+
+	struct CounterOptions : DefaultOptions {
+		static constexpr bool collect_counters = true;
+	};
+
+	struct IndexedLevelOptions : DefaultOptions {
+		static constexpr bool indexed_levels = true;
+	};
+
+	struct SnapshotOptions : DefaultOptions {
+		static constexpr bool snapshots = true;
+	};
+
+	struct OrderStatisticOptions : DefaultOptions {
+		static constexpr bool order_statistics = true;
+	};
 
 	/**
-	 *  When the number of elements in the bottom layer > 2 ^ (current level count), add a new level.
-	 *  Conversely, if the number of blocks in the bottom layer < 2 ^ (current level count - 1), remove the topmost level.
+	 *  When the number of blocks in the bottom layer reaches 2 ^ (current level), add a new level.
+	 *  Conversely, if the number of blocks in the bottom layer < 2 ^ (current level - 2), remove the topmost level,
+	 *  the gap keeps a width moving around a power of 2 from adding and dropping the same level over and over.
 	 *  Therefore, even when used as a regular array, it still functions as a skip list with a expected complexity of (log(n / capacityLimit) + 1) to (log(n) + 1).
 	 *
 	 *  Only inserting sparse and vector too empty creates new nodes
 	 *  and when deleted, they are deleted in place instead of splitting
 	 *  avoiding the complexity caused by merging and splitting
+	 *
+	 *  A block covers [baseIndex, baseIndex + capacity_count) clipped by the baseIndex of its right block.
+	 *  New blocks are aligned to index_align whenever the left block allows it, only compact() may
+	 *  re-home a block onto an unaligned base, every lookup works on the floor block so both are correct.
+	 *
+	 *  A run of consecutive blocks can be promoted into one extent, the blocks are stored contiguously
+	 *  and only the head takes part in the levels above 0, so a descent jumps into the extent in O(1)
+	 *  and a scan walks it like an array. Emptying a block of an extent dissolves it back into pool nodes.
 	 */
-	template <typename index_t, typename value_t, typename = std::enable_if<std::is_integral_v<index_t>&& std::is_trivial_v<value_t>&& std::is_standard_layout_v<value_t>>>
+	template <typename index_t, typename value_t, typename bitMap_t = uint16_t, typename Options = bbsl::DefaultOptions>
 	class BitmappedBlockSkipList {
+		static_assert(std::is_integral_v<index_t>, "index_t must be an integral type");
+		static_assert(std::is_unsigned_v<bitMap_t> && sizeof(bitMap_t) <= 8, "bitMap_t must be uint8_t, uint16_t, uint32_t or uint64_t");
+		static_assert(std::is_copy_constructible_v<value_t> && std::is_move_constructible_v<value_t> && std::is_nothrow_destructible_v<value_t>,
+			"value_t must be copyable, movable and destructible");
+
+	public:
+		// block width, pick bitMap_t so that a node fits your cache lines best
+		static constexpr uint64_t capacity_count = sizeof(bitMap_t) * 8;
+		static constexpr uint64_t index_align = (capacity_count - 1); // Align to capacity limit
+		static constexpr bitMap_t full_mask = static_cast<bitMap_t>(~static_cast<bitMap_t>(0));
+		static constexpr uint32_t index_cache_slots = Options::index_cache_slots;
+		static_assert((index_cache_slots & (index_cache_slots - 1)) == 0, "index_cache_slots must be 0 or a power of 2");
+		static constexpr bool collect_counters = Options::collect_counters;
+		static constexpr bool indexed_levels = Options::indexed_levels;
+		static constexpr bool snapshots = Options::snapshots;
+		static_assert(!(snapshots && Options::extent_blocks != 0), "extents are not shared with snapshots, pick one of them");
+		static constexpr bool order_statistics = Options::order_statistics;
+		// trivial values live in a plain array and are copied as a whole, the others are constructed and destroyed by the bitmap
+		static constexpr bool trivial_values = std::is_trivial_v<value_t>;
+		static_assert(trivial_values || !snapshots, "snapshots share blocks without owning their values, value_t must be trivial");
+		// the inside of an extent has no tower, a count update would walk to its head block by block
+		static_assert(!(order_statistics && Options::extent_blocks != 0), "extents do not keep link counts, pick one of them");
+
+		/**
+		 * @brief what the list did since it was created or since resetCounters, all 0 unless Options::collect_counters
+		 */
+		struct Counters {
+			uint64_t descents = 0;			// walks from a sentry or a finger down to level 0
+			uint64_t descentHops = 0;		// right moves taken by the descents
+			uint64_t fingerHits = 0;		// operator[] served by the last path without a descent
+			uint64_t fingerMisses = 0;
+			uint64_t levelIncreases = 0;
+			uint64_t levelDecreases = 0;
+			uint64_t nodeInserts = 0;
+			uint64_t nodeRemoves = 0;
+
+			double fingerHitRate() const {
+				const uint64_t tries = this->fingerHits + this->fingerMisses;
+				return (tries != 0) ? static_cast<double>(this->fingerHits) / static_cast<double>(tries) : 0;
+			}
+
+			double hopsPerDescent() const {
+				return (this->descents != 0) ? static_cast<double>(this->descentHops) / static_cast<double>(this->descents) : 0;
+			}
+		};
+
 	protected:
 		/**
 		 * @brief	It's just for storing data, so it's struct
@@ -76,36 +399,63 @@ namespace bbsl {
 		 * In order to compress the memory occupied by a single node, we do not apply STL containers
 		 */
 		struct SkipListNode {
-			SkipListNode** nodes = nullptr;		//right = level*2 ,left = level * 2 + 1
+			// the overflow always holds every level above the inline tower, so one unit size fits all nodes including the sentries
+			// with order statistics the counts of those levels follow the links in the same unit
+			static constexpr size_t overflow_links = (bbsl::max_level - bbsl::inline_levels) * 2;
+			static constexpr size_t overflow_size = sizeof(SkipListNode*) * overflow_links
+				+ (order_statistics ? sizeof(uint64_t) * (bbsl::max_level - bbsl::inline_levels) : 0);
+
 			index_t baseIndex;					//The array is offset by the index, which is almost unmodified
 
 			bitMap_t bitMap = 0;				//use bitMap to manage
-			uint8_t node_capacity;				//real capacity = *2
 			uint8_t level;						//height
+			// set when the block left the list for the snapshots that still read it, it is never written again
+			std::conditional_t<snapshots, bool, bbsl::NoStamp> retired = {};
+			// generation the block was made in, or left the list in, an empty struct in the padding without snapshots
+			std::conditional_t<snapshots, uint64_t, bbsl::NoStamp> stamp = {};
+			uint16_t span = 1;					//1 for a pool node, n for the head of an extent of n blocks, 0 inside an extent
+
+			SkipListNode* tower[bbsl::inline_levels * 2];	//right = level*2 ,left = level * 2 + 1, shares the cache line with baseIndex
+			SkipListNode** overflow = nullptr;				//levels >= inline_levels, allocated from the tower pool of the list
+			// elements from this node up to its right node on the inline levels, level 0 is the popcount and is not stored
+			std::conditional_t<order_statistics, uint64_t[bbsl::inline_levels], bbsl::NoStamp> counts = {};
 
-			value_t elements[capacity_count];	//inline elements, avoid extra allocation when the node is not full, and the capacity is not large
+			//inline elements, avoid extra allocation when the node is not full, and the capacity is not large
+			//trivial values are zeroed once, so the block kernels never read indeterminate holes
+			std::conditional_t<trivial_values, value_t[capacity_count], bbsl::RawSlots<value_t, capacity_count>> elements = {};
 
 		public:
-			SkipListNode(const index_t baseIndex = 0, const uint8_t level = 0) {
+			SkipListNode() : baseIndex(0), level(0) {
+				std::fill_n(this->tower, bbsl::inline_levels * 2, nullptr);
+			}
+
+			SkipListNode(const index_t baseIndex, const uint8_t level, BitmappedBlockSkipList& list) {
 				this->baseIndex = baseIndex;
-				this->node_capacity = bits::ceil<uint8_t>(level + 1);
 				this->level = level;
 
-				//allocate nodePtrs
-				this->nodes = bbsl::_realloc(this->nodes, 0, this->node_capacity << 1);
-				std::fill_n(this->nodes, this->node_capacity << 1, nullptr);
+				std::fill_n(this->tower, bbsl::inline_levels * 2, nullptr);
+				if (level >= bbsl::inline_levels) {
+					this->overflow = static_cast<SkipListNode**>(list.towers().allocate());
+					std::fill_n(this->overflow, (level + 1 - bbsl::inline_levels) << 1, nullptr);
+				}
 			}
 
-			~SkipListNode() {
-				//no ownership
-				bbsl::_realloc(this->nodes, this->node_capacity << 1, 0);
+			/**
+			 * @brief the node does not know its list, so the list must return the overflow before dropping the node
+			 * @param list
+			 */
+			void releaseTower(BitmappedBlockSkipList& list) {
+				if (this->overflow != nullptr) {
+					list.towerPool->deallocate(this->overflow);
+					this->overflow = nullptr;
+				}
 			}
 
 			/**
 			 * @brief if the node is empty
 			 * @return
 			 */
-			bool isEmpty() {
+			bool isEmpty() const {
 				return this->bitMap == 0;
 			}
 
@@ -114,8 +464,8 @@ namespace bbsl {
 			 * @param index
 			 * @return
 			 */
-			bool hasElement(const uint8_t index) {
-				return (index < bbsl::capacity_count) && bits::get(this->bitMap, index);
+			bool hasElement(const uint8_t index) const {
+				return (index < capacity_count) && bits::get(this->bitMap, index);
 			}
 
 			/**
@@ -124,182 +474,768 @@ namespace bbsl {
 			 * only when it is valid, the value will be set
 			 */
 			void getElement(const uint8_t index, value_t& value) const {
-				//if (index >= bbsl::capacity_count) return;
+				//if (index >= capacity_count) return;
 				//set value
 				if (bits::get(this->bitMap, index)) value = this->elements[index];
 			}
 
 			/**
+			 * @brief construct the slot from args, a taken slot is assigned instead
 			 * @param index
-			 * @param value
+			 * @param args
+			 * @return true if the slot was empty, so the list can keep its element count
 			 */
-			void setElement(const uint8_t index, const value_t& value) {
-				//if (index >= bbsl::capacity_count) return;
+			template <typename... Args>
+			bool emplaceElement(const uint8_t index, Args&&... args) {
+				//if (index >= capacity_count) return;
 
 				//set value and bitmap
-				this->elements[index] = value;
+				const bool added = !bits::get(this->bitMap, index);
+				if constexpr (trivial_values) {
+					this->elements[index] = value_t(std::forward<Args>(args)...);
+				}
+				else {
+					if (added) new (this->elements.at(index)) value_t(std::forward<Args>(args)...);
+					else this->elements[index] = value_t(std::forward<Args>(args)...);
+				}
 				bits::set_one(this->bitMap, index);
+				return added;
+			}
+
+			/**
+			 * @param index
+			 * @param value
+			 * @return true if the slot was empty, so the list can keep its element count
+			 */
+			bool setElement(const uint8_t index, const value_t& value) {
+				if constexpr (trivial_values) {
+					const bool added = !bits::get(this->bitMap, index);
+					this->elements[index] = value;
+					bits::set_one(this->bitMap, index);
+					return added;
+				}
+				else {
+					if (bits::get(this->bitMap, index)) {
+						this->elements[index] = value;
+						return false;
+					}
+					return this->emplaceElement(index, value);
+				}
 			}
 
 			/**
-			 * @brief logic delete
+			 * @brief logic delete, the value is destroyed unless it is trivial
 			 * @param index
 			 */
 			void deleteElement(const uint8_t index) {
-				//if (index >= bbsl::capacity_count) return;
+				//if (index >= capacity_count) return;
+				if constexpr (!trivial_values) std::destroy_at(&this->elements[index]);
 				bits::set_zero(this->bitMap, index);
 			}
 
-			void increaseLevel() {
-				if ((this->level + 1) >= this->node_capacity) {
-					uint8_t newCapacity = this->node_capacity << 1;
-					this->nodes = bbsl::_realloc(this->nodes, this->node_capacity << 1, newCapacity << 1);
-					this->node_capacity = newCapacity;
+			/**
+			 * @brief delete every element under mask
+			 * @param mask a subset of bitMap
+			 */
+			void clearElements(const bitMap_t mask) {
+				this->destroyElements(mask);
+				this->bitMap &= static_cast<bitMap_t>(~mask);
+			}
+
+			/**
+			 * @brief end the lifetime of the values under mask and leave the bitmap alone, before the block is dropped
+			 * @param mask a subset of bitMap
+			 */
+			void destroyElements(const bitMap_t mask) {
+				if constexpr (!trivial_values) {
+					bitMap_t live = mask;
+					while (live != 0) {
+						const uint8_t i = bits::ctz(live);
+						std::destroy_at(&this->elements[i]);
+						bits::set_zero(live, i);
+					}
+				}
+			}
+
+			/**
+			 * @brief take the elements of source, this node must be empty
+			 * @param source
+			 */
+			void copyElements(const SkipListNode& source) {
+				if constexpr (trivial_values) {
+					std::copy_n(source.elements, capacity_count, this->elements);
+				}
+				else {
+					bitMap_t mask = source.bitMap;
+					while (mask != 0) {
+						const uint8_t i = bits::ctz(mask);
+						new (this->elements.at(i)) value_t(source.elements[i]);
+						bits::set_zero(mask, i);
+					}
+				}
+				this->bitMap = source.bitMap;
+			}
+
+			/**
+			 * @brief move the elements of source here, this node must be empty and source is left empty
+			 * @param source
+			 */
+			void relocateElements(SkipListNode& source) {
+				if constexpr (trivial_values) {
+					std::copy_n(source.elements, capacity_count, this->elements);
+					this->bitMap = source.bitMap;
+				}
+				else {
+					bitMap_t mask = source.bitMap;
+					while (mask != 0) {
+						const uint8_t i = bits::ctz(mask);
+						this->moveElement(i, source, i);
+						bits::set_zero(mask, i);
+					}
+				}
+				source.bitMap = 0;
+			}
+
+			/**
+			 * @brief move the element at from of source into the empty slot at to
+			 * @param to
+			 * @param source
+			 * @param from a taken slot of source
+			 */
+			void moveElement(const uint8_t to, SkipListNode& source, const uint8_t from) {
+				if constexpr (trivial_values) {
+					this->elements[to] = source.elements[from];
+				}
+				else {
+					new (this->elements.at(to)) value_t(std::move(source.elements[from]));
+					std::destroy_at(&source.elements[from]);
+				}
+				bits::set_one(this->bitMap, to);
+				bits::set_zero(source.bitMap, from);
+			}
+
+			/**
+			 * @brief move every element down by shift slots, for a new base
+			 * @param shift no element may be below it
+			 */
+			void shiftElements(const uint8_t shift) {
+				if constexpr (trivial_values) {
+					std::move(this->elements + shift, this->elements + capacity_count, this->elements);
+					this->bitMap >>= shift;
+				}
+				else {
+					// upwards, so a slot is only written after its own element moved out
+					bitMap_t mask = this->bitMap;
+					while (mask != 0) {
+						const uint8_t i = bits::ctz(mask);
+						this->moveElement(static_cast<uint8_t>(i - shift), *this, i);
+						bits::set_zero(mask, i);
+					}
 				}
+			}
+
+			void increaseLevel(BitmappedBlockSkipList& list) {
 				++this->level;
-				std::fill_n(this->nodes + (this->level << 1), 2, nullptr);
+				if (this->level == bbsl::inline_levels && this->overflow == nullptr) {
+					this->overflow = static_cast<SkipListNode**>(list.towers().allocate());
+				}
+				SkipListNode** slot = this->slotOf(this->level);
+				slot[0] = nullptr;
+				slot[1] = nullptr;
 			}
 
 			void decreaseLevel() {
+				// keep the overflow, the level may come back soon
 				--this->level;
 			}
 
+			SkipListNode** slotOf(const uint8_t level) {
+				return (level < bbsl::inline_levels) ? (this->tower + (level << 1)) : (this->overflow + ((level - bbsl::inline_levels) << 1));
+			}
+
+			SkipListNode* const* slotOf(const uint8_t level) const {
+				return (level < bbsl::inline_levels) ? (this->tower + (level << 1)) : (this->overflow + ((level - bbsl::inline_levels) << 1));
+			}
+
 			SkipListNode* getLeftNode(const uint8_t level) const {
-				return this->nodes[(level << 1) | 1];
+				return this->slotOf(level)[1];
+			}
+
+			/**
+			 * @brief the stored count of the link on level, 1 <= level <= this->level, only with order statistics
+			 */
+			uint64_t& countOf(const uint8_t level) {
+				if (level < bbsl::inline_levels) return this->counts[level];
+				return reinterpret_cast<uint64_t*>(this->overflow + overflow_links)[level - bbsl::inline_levels];
+			}
+
+			uint64_t countOf(const uint8_t level) const {
+				if (level < bbsl::inline_levels) return this->counts[level];
+				return reinterpret_cast<const uint64_t*>(this->overflow + overflow_links)[level - bbsl::inline_levels];
 			}
 
 			SkipListNode* getRightNode(const uint8_t level) const {
-				return this->nodes[(level << 1)];
+				return this->slotOf(level)[0];
 			}
 
 			void setLeftNode(const uint8_t level, SkipListNode* node) {
-				this->nodes[(level << 1) | 1] = node;
+				this->slotOf(level)[1] = node;
 			}
 
 			void setRightNode(const uint8_t level, SkipListNode* node) {
-				this->nodes[(level << 1)] = node;
+				this->slotOf(level)[0] = node;
 			}
 
 			static bool isIndexValid(const uint64_t index) {
-				return index < bbsl::capacity_count;
+				return index < capacity_count;
 			}
 
 			static int8_t begin(const SkipListNode* node) {
 				if (node->bitMap == 0) return -1;
-				return bits::ctz64(node->bitMap);
+				return bits::ctz(node->bitMap);
 			}
 
 			static int8_t end(const SkipListNode* node) {
 				if (node->bitMap == 0) return -1;
-				uint8_t clzValue = bits::clz64(node->bitMap) - (64 - bbsl::capacity_count);
-				return bbsl::capacity_count - clzValue - 1;
+				return capacity_count - bits::clz(node->bitMap) - 1;
 			}
 
 			static int8_t next(const SkipListNode* node, const int8_t index) {
-				if (index >= bbsl::capacity_count) return -1;
+				if (index + 1 >= static_cast<int64_t>(capacity_count)) return -1;
 				// 0b00101100, index = 2, nextBits = 0b00001011, nextIndex = 3
 				bitMap_t nextBits = node->bitMap >> (index + 1);
 				if (nextBits == 0) return -1; // ctz will return 64 if the input is 0, so we must directly return -1
-				return index + bits::ctz64(nextBits) + 1;
+				return index + bits::ctz(nextBits) + 1;
 			}
 
 			static int8_t prev(const SkipListNode* node, const int8_t index) {
-				if (index >= bbsl::capacity_count || index == 0) return -1;
+				if (index >= static_cast<int64_t>(capacity_count) || index <= 0) return -1;
 				// 0b00101100, index = 5, prevBits = 0b01100000, prevIndex = 3
-				bitMap_t prevBits = node->bitMap << (bbsl::capacity_count - index);
+				bitMap_t prevBits = node->bitMap << (capacity_count - index);
 				if (prevBits == 0) return -1;// clz will return 64 if the input is 0, so we must directly return -1
-				uint8_t clzValue = bits::clz64(node->bitMap) - (64 - bbsl::capacity_count);
-				return index - clzValue - 1;
+				return index - bits::clz(prevBits) - 1;
 			}
 		};
 
 	protected:
-		mutable SkipListNode* leftPathNodes[32] = { nullptr };
-		slab::ObjectPool<SkipListNode> nodePool;
+		/**
+		 * @brief pull every cache line of a node, used by the level 0 scans
+		 */
+		static void prefetchNode(const SkipListNode* node) {
+			for (size_t offset = 0; offset < sizeof(SkipListNode); offset += bbsl::cache_line_size) {
+				bbsl::prefetch(reinterpret_cast<const char*>(node) + offset);
+			}
+		}
+
+		/**
+		 * @brief issue the two candidates of the next descent step, baseIndex and the inline tower share the first line
+		 */
+		static void prefetchDescent(const SkipListNode* node, const int64_t curLevel) {
+			if constexpr (Options::prefetch_descent) {
+				bbsl::prefetch(node->getRightNode(static_cast<uint8_t>(curLevel)));
+				if (curLevel > 0) bbsl::prefetch(node->getRightNode(static_cast<uint8_t>(curLevel - 1)));
+			}
+		}
+
+		/**
+		 * @brief companion of a level 0 walk, keeps a cursor prefetch_distance nodes ahead of it
+		 */
+		class ScanAhead {
+		private:
+			const SkipListNode* ahead = nullptr;
+			const SkipListNode* tail = nullptr;
+
+		public:
+			ScanAhead(const SkipListNode* start, const SkipListNode* tail) {
+				if constexpr (Options::prefetch_distance > 0) {
+					this->ahead = start;
+					this->tail = tail;
+					for (uint8_t i = 0; i < Options::prefetch_distance && this->ahead != this->tail; ++i) {
+						this->ahead = this->ahead->getRightNode(0);
+						prefetchNode(this->ahead);
+					}
+				}
+			}
+
+			void step() {
+				if constexpr (Options::prefetch_distance > 0) {
+					if (this->ahead != this->tail) {
+						this->ahead = this->ahead->getRightNode(0);
+						prefetchNode(this->ahead);
+					}
+				}
+			}
+		};
+
+		SkipListNode* leftPathNodes[bbsl::max_level] = { nullptr };	//only written by the mutating path, readers keep their path on the stack
+																	//either [0] is nullptr, or [0..level] is the exact predecessor path of some key
+		std::pmr::memory_resource* upstream = nullptr;	//backs the slabs and the extents, nullptr means slab::_malloc, travels with the pools
+		// pools are held by pointer, so moving a list is a pointer swap and never touches the slabs
+		// both are made on first use, so an empty or moved-from list holds no slab
+		// node slabs grow from 64 to 1024 units, so a growing array reaches upstream about once per 1024 blocks
+		// a counting list also counts the traffic of its pools
+		using NodePool = slab::ObjectPool<SkipListNode, collect_counters>;
+		using TowerPool = slab::SlabAllocator<collect_counters>;
+		NodePool* nodePool = nullptr;
+		TowerPool* towerPool = nullptr;	// made by towers() on the first tall node, most lists stay on the inline levels
 		bbsl::Xoroshiro64StarStar rng;
 
 		SkipListNode sentryHead;
 		SkipListNode sentryTail;
 
 		uint64_t width = 0;//the node count
+		uint64_t elementCount = 0;//the element count, kept on every bitmap transition
 		int64_t level = 0;//the height
+		uint64_t version = 0;//bumped on every structural change, used to validate ReadFinger
+		uint64_t extentCount = 0;//extents are allocated outside the pools and must be freed one by one
+		bool unaligned = false;//some block sits on an unaligned base, so a block may be clipped by its right block
+		SkipListNode* compactCursor = nullptr;//where compactStep continues, nullptr means from the beginning
 
-		value_t invalid;//you need an invalid default value
+		// filled by the mutating path only, so const readers may share it, a node leaves it before it is freed or rebased
+		SkipListNode* indexCache[index_cache_slots != 0 ? index_cache_slots : 1] = { nullptr };
 
-		//check if need add level
-		void increaseLevel() {
-			// 1. level up sentry
-			this->sentryHead.increaseLevel();
-			this->sentryTail.increaseLevel();
-			++this->level;
+		value_t invalid;//you need an invalid default value
 
-			// 2. get nodes witch level == this->level - 1
-			SkipListNode* node = this->sentryHead.getRightNode(this->level - 1);
-			SkipListNode* left = &this->sentryHead;
+		struct NoCounters {};
+		// not carried by copies, moves or swaps, the numbers describe this object
+		mutable std::conditional_t<collect_counters, Counters, NoCounters> counts;
 
-			while (node->level < (this->level - 1)) {
-				node = node->getRightNode(this->level - 1);
-			}
+		void tally(uint64_t Counters::* field) const {
+			if constexpr (collect_counters) ++(this->counts.*field);
+		}
 
-			//at least one node
-			bool promoted = false;
+		NodePool* makeNodePool() const {
+			return new NodePool(4, this->upstream, slab::SlabGeometry{ 64, 1024 });
+		}
 
-			while (node != &this->sentryTail) {
-				// 50% percent
-				if ((this->rng.next() & 1) || !promoted) {
-					node->increaseLevel();
-					// connect node
-					node->setLeftNode(this->level, left);
-					left->setRightNode(this->level, node);
-					left = node;
+		TowerPool* makeTowerPool() const {
+			return new TowerPool(static_cast<uint32_t>(SkipListNode::overflow_size), 4, this->upstream);
+		}
 
-					promoted = true;
-				}
-				node = node->getRightNode(this->level - 1);
-			}
+		/**
+		 * @brief the node pool, made on the first block
+		 */
+		NodePool& nodes() {
+			if (this->nodePool == nullptr) this->nodePool = this->makeNodePool();
+			return *this->nodePool;
+		}
 
-			//connect
-			left->setRightNode(this->level, &this->sentryTail);
-			this->sentryTail.setLeftNode(this->level, left);
+		/**
+		 * @brief the tower pool, made on the first overflow tower
+		 */
+		TowerPool& towers() {
+			if (this->towerPool == nullptr) this->towerPool = this->makeTowerPool();
+			return *this->towerPool;
 		}
 
-		//check if need sub level
-		void decreaseLevel() {
-			//level down all node that level == this.level
-			SkipListNode* node = &this->sentryHead;
+		/**
+		 * @brief what a snapshot sees, the blocks of the list at the time it was taken in baseIndex order
+		 */
+		struct SnapshotState {
+			SnapshotState* older = nullptr;
+			SnapshotState* newer = nullptr;
+			uint64_t generation = 0;
+			const SkipListNode** nodes = nullptr;
+			uint64_t blockCount = 0;
+			uint64_t elementCount = 0;
+		};
 
-			while (node != nullptr) {
-				SkipListNode* right = node->getRightNode(this->level);
-				node->decreaseLevel();
-				node = right;
+		/**
+		 * @brief shared by a list and its snapshots, a snapshot may be dropped on any thread
+		 * only the owning thread creates snapshots and writes the list, so newest can only go down behind its back,
+		 * which at worst makes it copy a block that is not shared anymore
+		 */
+		struct SnapshotRegistry {
+			std::mutex lock;								// guards the chain of live states
+			std::atomic<uint64_t> references{ 1 };			// the list plus every live snapshot
+			std::atomic<uint64_t> newest{ 0 };				// generation of the newest live snapshot, 0 when there is none
+			SnapshotState* oldestState = nullptr;
+			SnapshotState* newestState = nullptr;
+			// pools the list let go (cleared, assigned, destroyed) while snapshots still read their nodes
+			NodePool* orphanNodes = nullptr;
+			TowerPool* orphanTowers = nullptr;
+
+			~SnapshotRegistry() {
+				delete this->orphanNodes;
+				delete this->orphanTowers;
 			}
 
-			--this->level;
+			static void release(SnapshotRegistry* registry) {
+				if (registry->references.fetch_sub(1, std::memory_order_acq_rel) == 1) delete registry;
+			}
+		};
+
+		SnapshotRegistry* registry = nullptr;	// created by the first snapshot()
+		uint64_t generation = 0;				// bumped by every snapshot(), new and copied blocks are stamped with it
+		SkipListNode* detached = nullptr;		// blocks that left the list while a snapshot may read them, linked through tower[0]
+		uint64_t detachedCount = 0;
+		uint64_t reclaimedBelow = 0;			// every detached block stamped below this is already freed
+
+		bool hasLiveSnapshots() const {
+			if constexpr (snapshots) {
+				return this->registry != nullptr && this->registry->newest.load(std::memory_order_acquire) != 0;
+			}
+			else return false;
 		}
 
 		/**
-		 * @brief
-		 * @return
+		 * @brief a block is shared when it is older than the newest live snapshot, a block that left the list always is
 		 */
-		uint8_t getRandomLevel() {
-			//limit level [0-31]
-			const auto count = bits::ctz64(this->rng.next()) & 31;
-			return (count <= this->level) ? count : this->level;
+		bool isShared(const SkipListNode* node) const {
+			if constexpr (snapshots) {
+				if (node->retired) return true;
+				return this->registry != nullptr && node->stamp < this->registry->newest.load(std::memory_order_acquire);
+			}
+			else return false;
+		}
+
+		void stamp(SkipListNode* node) const {
+			if constexpr (snapshots) node->stamp = this->generation;
 		}
 
 		/**
-		 * @brief
-		 * @param index
+		 * @brief the elements the link of node on level skips, those of node included
 		 */
-		SkipListNode* findLeftNode(const index_t index) const {
-			SkipListNode* node = const_cast<SkipListNode*>(&this->sentryHead);
+		static uint64_t linkCount(const SkipListNode* node, const uint8_t level) {
+			if (level == 0) return bits::popcnt(node->bitMap);
+			if constexpr (order_statistics) return node->countOf(level);
+			else return 0;
+		}
+
+		/**
+		 * @brief node gained or lost elements, fix the link over it on every level above 0
+		 * the link of level i belongs to the first node at or left of node that is tall enough, so it is one walk up the towers
+		 */
+		void countElements(SkipListNode* node, const int64_t delta) {
+			if constexpr (order_statistics) {
+				for (uint8_t i = 1; i <= this->level; ++i) {
+					while (node->level < i) node = node->getLeftNode(i - 1);
+					node->countOf(i) += static_cast<uint64_t>(delta);
+				}
+			}
+		}
+
+		/**
+		 * @brief O(blocks), recount every link from the level below, after the towers were rebuilt
+		 */
+		void rebuildCounts() {
+			if constexpr (order_statistics) {
+				for (uint8_t i = 1; i <= this->level; ++i) {
+					SkipListNode* owner = &this->sentryHead;
+					uint64_t pending = 0;
+					for (SkipListNode* node = &this->sentryHead; node != &this->sentryTail; node = node->getRightNode(i - 1)) {
+						if (node != &this->sentryHead && node->level >= i) {
+							owner->countOf(i) = pending;
+							owner = node;
+							pending = 0;
+						}
+						pending += linkCount(node, i - 1);
+					}
+					owner->countOf(i) = pending;
+				}
+			}
+		}
+
+		/**
+		 * @brief the node leaves the list but stays readable until every snapshot that may see it is gone
+		 */
+		void detach(SkipListNode* node) {
+			if constexpr (snapshots) {
+				node->releaseTower(*this);
+				// the stamp turns into the generation it left in, the flag keeps it shared for a stale pointer
+				node->retired = true;
+				node->stamp = this->generation;
+				node->setRightNode(0, this->detached);
+				this->detached = node;
+				// like the retired list of the concurrent variant, look for free blocks every 64 of them
+				if ((++this->detachedCount & 63) == 0) this->reclaimDetached();
+			}
+		}
+
+		/**
+		 * @brief free the detached blocks no live snapshot can see, one left the list after every snapshot up to its stamp
+		 */
+		void reclaimDetached() {
+			if constexpr (snapshots) {
+				if (this->detached == nullptr) return;
+
+				uint64_t oldest = UINT64_MAX;
+				{
+					std::lock_guard<std::mutex> guard(this->registry->lock);
+					if (this->registry->oldestState != nullptr) oldest = this->registry->oldestState->generation;
+				}
+				// the oldest live generation only grows, nothing new is free until it moves
+				oldest = std::min(oldest, this->generation + 1);
+				if (oldest <= this->reclaimedBelow) return;
+				this->reclaimedBelow = oldest;
+
+				SkipListNode** link = &this->detached;
+				while (*link != nullptr) {
+					SkipListNode* node = *link;
+					if (node->stamp < oldest) {
+						*link = node->getRightNode(0);
+						this->nodePool->deallocate(node);
+						--this->detachedCount;
+					}
+					else {
+						link = &node->tower[0];
+					}
+				}
+			}
+		}
+
+		/**
+		 * @brief before a write, swap a shared block for a private copy in the same place of every level
+		 * @param node a block of the list, an iterator looks a retired block up by its key first
+		 * @return the node to write
+		 */
+		SkipListNode* own(SkipListNode* node) {
+			if constexpr (snapshots) {
+				assert(!node->retired && "own: the block already left the list");
+				if (!this->isShared(node)) return node;
+
+				SkipListNode* copy = this->nodes().allocate(node->baseIndex, node->level, *this);
+				this->stamp(copy);
+				copy->copyElements(*node);
+				if constexpr (order_statistics) {
+					for (uint8_t i = 1; i <= node->level; ++i) copy->countOf(i) = node->countOf(i);
+				}
+
+				for (uint8_t i = 0; i <= node->level; ++i) {
+					SkipListNode* left = node->getLeftNode(i);
+					SkipListNode* right = node->getRightNode(i);
+					copy->setLeftNode(i, left);
+					copy->setRightNode(i, right);
+					left->setRightNode(i, copy);
+					right->setLeftNode(i, copy);
+					if (this->leftPathNodes[i] == node) this->leftPathNodes[i] = copy;
+				}
+				if (this->compactCursor == node) this->compactCursor = copy;
+				this->forget(node);
+				this->remember(copy, copy->baseIndex);
+				++this->version;
+
+				this->detach(node);
+				return copy;
+			}
+			else return node;
+		}
+
+		/**
+		 * @brief write the blocks as serialize() lays them out, shared by the list and its snapshots
+		 * @param out
+		 * @param elementCount
+		 * @param walk walk(func) calls func(const SkipListNode*) for every block in baseIndex order, it is called four times
+		 * @return false if the stream failed
+		 */
+		template<typename Walk>
+		static bool writeBlocks(std::ostream& out, const uint64_t elementCount, Walk walk) {
+			uint64_t blocks = 0;
+			uint64_t payload = 0;
+			walk([&](const SkipListNode* node) {
+				++blocks;
+				payload += format::recordBytes(bits::popcnt(node->bitMap), sizeof(value_t));
+				});
+
+			const format::FileHeader header = format::makeHeader<index_t, value_t, bitMap_t>(blocks, elementCount, sizeof(format::FileHeader) + payload);
+			out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+			// the records, elements packed in index order
+			static constexpr char zeros[8] = { 0 };
+			value_t packed[capacity_count];
+			walk([&](const SkipListNode* node) {
+				const format::BlockHeader block = { format::encodeIndex(node->baseIndex), static_cast<uint64_t>(node->bitMap) };
+				out.write(reinterpret_cast<const char*>(&block), sizeof(block));
+
+				uint64_t count = 0;
+				bitMap_t mask = node->bitMap;
+				while (mask != 0) {
+					const uint8_t i = bits::ctz(mask);
+					packed[count++] = node->elements[i];
+					bits::set_zero(mask, i);
+				}
+				const uint64_t bytes = count * sizeof(value_t);
+				out.write(reinterpret_cast<const char*>(packed), bytes);
+				out.write(zeros, format::padded(bytes) - bytes);
+				});
+
+			// the directory, bases first so a reader can search them without touching the records
+			walk([&](const SkipListNode* node) {
+				const uint64_t base = format::encodeIndex(node->baseIndex);
+				out.write(reinterpret_cast<const char*>(&base), sizeof(base));
+				});
+			uint64_t offset = sizeof(format::FileHeader);
+			walk([&](const SkipListNode* node) {
+				out.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+				offset += format::recordBytes(bits::popcnt(node->bitMap), sizeof(value_t));
+				});
+
+			return out.good();
+		}
+
+		/**
+		 * @brief before the pools are reset or deleted, hand them to live snapshots, fresh ones are made on first use
+		 * @return true if the pools were handed over
+		 */
+		bool orphanPools() {
+			if constexpr (snapshots) {
+				if (this->registry == nullptr) return false;
+
+				bool orphaned = false;
+				{
+					std::lock_guard<std::mutex> guard(this->registry->lock);
+					if (this->registry->oldestState != nullptr) {
+						this->registry->orphanNodes = this->nodePool;
+						this->registry->orphanTowers = this->towerPool;
+						orphaned = true;
+					}
+				}
+				SnapshotRegistry::release(this->registry);
+				this->registry = nullptr;
+				this->detached = nullptr;
+				this->detachedCount = 0;
+
+				if (orphaned) {
+					this->nodePool = nullptr;
+					this->towerPool = nullptr;
+					// the overflow of the sentries went with the old tower pool
+					this->sentryHead.overflow = nullptr;
+					this->sentryTail.overflow = nullptr;
+				}
+				return orphaned;
+			}
+			else return false;
+		}
+
+		//check if need add level
+		void increaseLevel() {
+			this->tally(&Counters::levelIncreases);
+			// 1. level up sentry
+			this->sentryHead.increaseLevel(*this);
+			this->sentryTail.increaseLevel(*this);
+			++this->level;
+
+			// 2. get nodes witch level == this->level - 1
+			SkipListNode* node = this->sentryHead.getRightNode(this->level - 1);
+			SkipListNode* left = &this->sentryHead;
+
+			while (node->level < (this->level - 1)) {
+				node = node->getRightNode(this->level - 1);
+			}
+
+			//at least one node
+			bool promoted = false;
+
+			// the lower levels of the path stay exact, only its new top level is picked up on the way
+			const SkipListNode* key = this->leftPathNodes[0];
+			SkipListNode* top = &this->sentryHead;
+
+			// elements under the new link of left so far, counted off the level below
+			uint64_t pending = linkCount(&this->sentryHead, static_cast<uint8_t>(this->level - 1));
+			for (SkipListNode* skipped = this->sentryHead.getRightNode(this->level - 1); skipped != node; skipped = skipped->getRightNode(this->level - 1)) {
+				pending += linkCount(skipped, static_cast<uint8_t>(this->level - 1));
+			}
+
+			while (node != &this->sentryTail) {
+				// 50% percent (or the block number divides by 2 ^ level), the inside of an extent stays on level 0
+				if (node->span != 0 && (this->qualifies(node) || !promoted)) {
+					node->increaseLevel(*this);
+					// connect node
+					node->setLeftNode(this->level, left);
+					left->setRightNode(this->level, node);
+					if constexpr (order_statistics) left->countOf(static_cast<uint8_t>(this->level)) = pending;
+					pending = 0;
+					left = node;
+
+					if (key != nullptr && key != &this->sentryHead && node->baseIndex <= key->baseIndex) top = node;
+					promoted = true;
+				}
+				pending += linkCount(node, static_cast<uint8_t>(this->level - 1));
+				node = node->getRightNode(this->level - 1);
+			}
+
+			//connect
+			if constexpr (order_statistics) left->countOf(static_cast<uint8_t>(this->level)) = pending;
+			left->setRightNode(this->level, &this->sentryTail);
+			this->sentryTail.setLeftNode(this->level, left);
+
+			this->leftPathNodes[this->level] = top;
+		}
+
+		/**
+		 * @brief whether a node of the previous top level joins the new one
+		 */
+		bool qualifies(const SkipListNode* node) {
+			if constexpr (indexed_levels) return towerHeight(node->baseIndex) >= this->level;
+			else return (this->rng.next() & 1) != 0;
+		}
+
+		/**
+		 * @brief ctz of the block number, the deterministic height of the block at baseIndex
+		 */
+		static uint8_t towerHeight(const index_t baseIndex) {
+			return bits::ctz64(static_cast<uint64_t>(baseIndex) / capacity_count);
+		}
+
+		//check if need sub level
+		void decreaseLevel() {
+			//level down all node that level == this.level
+			SkipListNode* node = &this->sentryHead;
+
+			while (node != nullptr) {
+				SkipListNode* right = node->getRightNode(this->level);
+				node->decreaseLevel();
+				node = right;
+			}
+			this->tally(&Counters::levelDecreases);
+
+			--this->level;
+			this->leftPathNodes[0] = nullptr;
+		}
+
+		/**
+		 * @brief
+		 * @return
+		 */
+		uint8_t getRandomLevel(const index_t baseIndex) {
+			//limit level [0-31]
+			uint8_t count;
+			if constexpr (indexed_levels) count = std::min<uint8_t>(towerHeight(baseIndex), bbsl::max_level - 1);
+			else count = bits::ctz64(this->rng.next()) & 31;
+			return (count <= this->level) ? count : static_cast<uint8_t>(this->level);
+		}
+
+		/**
+		 * @brief at level 0 an extent head is left for the block of the extent holding index
+		 * the blocks of an extent are contiguous and their bases are consecutive
+		 * @param node
+		 * @param index
+		 * @return
+		 */
+		static SkipListNode* enterExtent(SkipListNode* node, const index_t index) {
+			if (node->span <= 1) return node;
+
+			const uint64_t offset = static_cast<uint64_t>(index - node->baseIndex) / capacity_count;
+			return node + ((offset < node->span) ? offset : (node->span - 1));
+		}
+
+		/**
+		 * @brief
+		 * @param index
+		 */
+		SkipListNode* findLeftNode(const index_t index) {
+			this->tally(&Counters::descents);
+			SkipListNode* node = &this->sentryHead;
 			auto curLevel = this->level;
 
 			while (curLevel >= 0) {
+				if (curLevel == 0) node = enterExtent(node, index);
 				auto next = node->getRightNode(curLevel);
 				// check next node, if it is nullptr, then go down a level
 				if (next != &this->sentryTail && next->baseIndex <= index) {
 					node = next;
+					this->tally(&Counters::descentHops);
+					prefetchDescent(node, curLevel);
 				}
 				else {
 					this->leftPathNodes[curLevel] = node;
@@ -310,6 +1246,190 @@ namespace bbsl {
 			return this->leftPathNodes[0];
 		}
 
+		/**
+		 * @brief finger search, climb from the level 0 of a previous path only as high as needed, then descend
+		 * @param path exact predecessor path of a previous key, or path[0] == nullptr to start from sentryHead
+		 * @param index
+		 * @return path[0], the maximum node with baseIndex <= index
+		 */
+		SkipListNode* findLeftNodeFrom(SkipListNode** path, const index_t index) const {
+			this->tally(&Counters::descents);
+			SkipListNode* node = const_cast<SkipListNode*>(&this->sentryHead);
+			auto curLevel = this->level;
+
+			if (path[0] != nullptr) {
+				// the predecessor at level i is still valid when it is <= index and its right node is > index
+				// both conditions only get weaker when climbing, so the first level that holds is the start point
+				int64_t i = 0;
+				for (; i < this->level; ++i) {
+					SkipListNode* left = path[i];
+					if (left == &this->sentryHead || left->baseIndex <= index) {
+						SkipListNode* next = left->getRightNode(i);
+						if (next == &this->sentryTail || next->baseIndex > index) break;
+					}
+				}
+
+				if (path[i] == &this->sentryHead || path[i]->baseIndex <= index) {
+					node = path[i];
+					curLevel = i;
+				}
+			}
+
+			while (curLevel >= 0) {
+				if (curLevel == 0) node = enterExtent(node, index);
+				auto next = node->getRightNode(curLevel);
+				if (next != &this->sentryTail && next->baseIndex <= index) {
+					node = next;
+					this->tally(&Counters::descentHops);
+					prefetchDescent(node, curLevel);
+				}
+				else {
+					path[curLevel] = node;
+					--curLevel;
+				}
+			}
+
+			return path[0];
+		}
+
+		/**
+		 * @brief check a remembered node without a descent
+		 * @param node
+		 * @param index
+		 * @return true if node is the floor block of index and index fits in it
+		 */
+		bool covers(const SkipListNode* node, const index_t index) const {
+			if (node == nullptr || node == &this->sentryHead || node->baseIndex > index || !SkipListNode::isIndexValid(index - node->baseIndex)) return false;
+			if (!this->unaligned) return true;
+
+			// unaligned blocks may overlap, the right block owns the overlap
+			const SkipListNode* right = node->getRightNode(0);
+			return right == &this->sentryTail || index < right->baseIndex;
+		}
+
+		/**
+		 * @brief base of a new block holding index
+		 * @param index
+		 * @param floor the floor node of index, it does not cover index
+		 * @return the aligned base, pushed right when the floor block would overlap it
+		 */
+		index_t baseFor(const index_t index, const SkipListNode* floor) {
+			index_t base = index - (index & index_align);
+			if (floor != nullptr && floor != &this->sentryHead && base < floor->baseIndex + static_cast<index_t>(capacity_count)) {
+				base = floor->baseIndex + static_cast<index_t>(capacity_count);
+				this->unaligned = true;
+			}
+			return base;
+		}
+
+		static size_t cacheSlot(const index_t index) {
+			return static_cast<size_t>(static_cast<uint64_t>(index) / capacity_count) & (index_cache_slots - 1);
+		}
+
+		/**
+		 * @brief the cached block of index
+		 * @param index
+		 * @return nullptr on a miss
+		 */
+		SkipListNode* cachedNode(const index_t index) const {
+			if constexpr (index_cache_slots != 0) {
+				SkipListNode* node = this->indexCache[cacheSlot(index)];
+				if (this->covers(node, index)) return node;
+			}
+			return nullptr;
+		}
+
+		void remember(SkipListNode* node, const index_t index) {
+			if constexpr (index_cache_slots != 0) {
+				this->indexCache[cacheSlot(index)] = node;
+			}
+		}
+
+		/**
+		 * @brief drop node from the cache, a block spans at most two slots
+		 * @param node
+		 */
+		void forget(const SkipListNode* node) {
+			if constexpr (index_cache_slots != 0) {
+				const size_t first = cacheSlot(node->baseIndex);
+				const size_t last = cacheSlot(node->baseIndex + static_cast<index_t>(capacity_count - 1));
+				if (this->indexCache[first] == node) this->indexCache[first] = nullptr;
+				if (this->indexCache[last] == node) this->indexCache[last] = nullptr;
+			}
+		}
+
+		void forgetAll() {
+			if constexpr (index_cache_slots != 0) {
+				std::fill_n(this->indexCache, index_cache_slots, nullptr);
+			}
+		}
+
+		/**
+		 * @brief find the maximum node with baseIndex <= index without recording the path
+		 * @param index
+		 * @return sentryHead if there is no such node
+		 */
+		SkipListNode* findFloorNode(const index_t index) const {
+			if constexpr (index_cache_slots != 0) {
+				SkipListNode* cached = this->cachedNode(index);
+				if (cached != nullptr) return cached;
+			}
+
+			this->tally(&Counters::descents);
+			SkipListNode* node = const_cast<SkipListNode*>(&this->sentryHead);
+			auto curLevel = this->level;
+
+			while (curLevel >= 0) {
+				if (curLevel == 0) node = enterExtent(node, index);
+				auto next = node->getRightNode(curLevel);
+				if (next != &this->sentryTail && next->baseIndex <= index) {
+					node = next;
+					this->tally(&Counters::descentHops);
+					prefetchDescent(node, curLevel);
+				}
+				else {
+					--curLevel;
+				}
+			}
+
+			return node;
+		}
+
+		/**
+		 * @brief walk [start, end) on level 0 after one descent, masking the bitmap of the first and last block
+		 * @param func return false to stop
+		 * @return false if func stopped the walk
+		 */
+		template<typename Func>
+		bool visitRange(const index_t start, const index_t end, Func func) const {
+			if (this->width == 0 || !(start < end)) return true;
+
+			SkipListNode* node = this->findFloorNode(start);
+			if (node == &this->sentryHead || !SkipListNode::isIndexValid(start - node->baseIndex)) {
+				node = node->getRightNode(0);
+			}
+
+			ScanAhead ahead(node, &this->sentryTail);
+			while (node != &this->sentryTail && node->baseIndex < end) {
+				bitMap_t mask = node->bitMap;
+				if (node->baseIndex < start) {
+					mask &= bits::mask_from<bitMap_t>(static_cast<uint8_t>(start - node->baseIndex));
+				}
+				if (SkipListNode::isIndexValid(end - node->baseIndex)) {
+					mask &= bits::mask_below<bitMap_t>(static_cast<uint8_t>(end - node->baseIndex));
+				}
+
+				while (mask != 0) {
+					const uint8_t i = bits::ctz(mask);
+					if (!func(node->elements[i], node->baseIndex + i)) return false;
+					bits::set_zero(mask, i);
+				}
+				ahead.step();
+				node = node->getRightNode(0);
+			}
+			return true;
+		}
+
 		/**
 		 * @brief
 		 * @param index
@@ -317,9 +1437,23 @@ namespace bbsl {
 		 */
 		SkipListNode* insertNode(const index_t index) {
 			//make node
-			const auto level = this->getRandomLevel();
-			SkipListNode* newNode = this->nodePool.allocate(index, level);
+			const auto level = this->getRandomLevel(index);
+			SkipListNode* newNode = this->nodes().allocate(index, level, *this);
 			//new SkipListNode(index, level);
+			this->stamp(newNode);
+			this->tally(&Counters::nodeInserts);
+
+			if constexpr (order_statistics) {
+				// the new node is empty, it takes the part of every link it splits that lies right of it
+				uint64_t before = linkCount(this->leftPathNodes[0], 0);
+				for (uint8_t i = 1; i <= level; ++i) {
+					for (SkipListNode* node = this->leftPathNodes[i]; node != this->leftPathNodes[i - 1]; node = node->getRightNode(i - 1)) {
+						before += linkCount(node, i - 1);
+					}
+					newNode->countOf(i) = this->leftPathNodes[i]->countOf(i) - before;
+					this->leftPathNodes[i]->countOf(i) = before;
+				}
+			}
 
 			//connect
 			SkipListNode* left = nullptr, * right = nullptr;
@@ -334,9 +1468,13 @@ namespace bbsl {
 				left->setRightNode(i, newNode);
 				newNode->setRightNode(i, right);
 				right->setLeftNode(i, newNode);
+
+				// the new node is the predecessor of the key now
+				this->leftPathNodes[i] = newNode;
 			}
 
 			++this->width;
+			++this->version;
 			if (this->width >= (1ULL << this->level)) {
 				increaseLevel();
 			}
@@ -345,256 +1483,2541 @@ namespace bbsl {
 		}
 
 		/**
-		 * @brief
+		 * @brief construct the first element of a block insertNode just linked, a throwing constructor takes the empty block out again
 		 * @param node
+		 * @param offset
+		 * @param args
+		 * @return the element
 		 */
-		void removeNode(SkipListNode* node) {
-			SkipListNode* left = nullptr, * right = nullptr;
-
-			for (auto i = 0; i <= node->level; ++i) {
-				// must call findLeftNode before removeNode, so leftPathNodes are valid
-				left = (this->leftPathNodes[i] != node) ? this->leftPathNodes[i] : node->getLeftNode(i);
-				right = node->getRightNode(i);
-
-				left->setRightNode(i, right);
-				right->setLeftNode(i, left);
+		template <typename... Args>
+		value_t& fillNewNode(SkipListNode* node, const uint8_t offset, Args&&... args) {
+			if constexpr (std::is_nothrow_constructible_v<value_t, Args&&...>) {
+				node->emplaceElement(offset, std::forward<Args>(args)...);
+			}
+			else {
+				try {
+					node->emplaceElement(offset, std::forward<Args>(args)...);
+				}
+				catch (...) {
+					this->removeNode(node);
+					throw;
+				}
 			}
+			++this->elementCount;
+			this->countElements(node, 1);
+			return node->elements[offset];
+		}
 
-			this->nodePool.deallocate(node);
-			//delete node;
-			--this->width;
+		/**
+		 * @brief the element at offset of node exists
+		 * @param node
+		 * @param offset
+		 */
+		void eraseElement(SkipListNode* node, const uint8_t offset) {
+			--this->elementCount;
 
-			// remind: we set path node after remove, so we never get invalid path node0
-			this->leftPathNodes[0] = nullptr;
+			// the last element of a shared block, the block leaves the list untouched and snapshots keep reading it
+			if (this->isShared(node) && bits::popcnt(node->bitMap) == 1) {
+				this->removeNode(node);
+				return;
+			}
+
+			node = this->own(node);
+			node->deleteElement(offset);
+			this->countElements(node, -1);
+			//remove node
+			if (node->isEmpty()) this->removeNode(node);
+		}
+
+		/**
+		 * @brief erase the elements of node under mask in one step, the block goes if nothing is left
+		 * @param node
+		 * @param mask a subset of node->bitMap
+		 * @return the right node of node
+		 */
+		SkipListNode* clearMask(SkipListNode* node, const bitMap_t mask) {
+			if (mask == 0) return node->getRightNode(0);
+
+			this->elementCount -= bits::popcnt(mask);
+			if (mask == node->bitMap) {
+				// the block goes, an extent is dissolved first so the right node stays valid
+				if (node->span != 1) node = this->dissolveExtent(node);
+				SkipListNode* right = node->getRightNode(0);
+				// a shared block keeps its values for the snapshots, only trivial values are shared
+				if (!this->isShared(node)) node->destroyElements(node->bitMap);
+				this->removeNode(node);
+				return right;
+			}
+
+			node = this->own(node);
+			node->clearElements(mask);
+			this->countElements(node, -static_cast<int64_t>(bits::popcnt(mask)));
+			return node->getRightNode(0);
+		}
+
+		/**
+		 * @brief the keys of a list in the window [base, base + capacity_count) as a bitmap relative to base
+		 * a block only holds keys below its right neighbour, so the floor block and the blocks starting inside the window are all,
+		 * with aligned bases that is the one block of the same base
+		 * @param node the floor block of base in its list, or its sentryHead
+		 * @param head
+		 * @param tail
+		 * @param base
+		 */
+		static bitMap_t keysAt(const SkipListNode* node, const SkipListNode* head, const SkipListNode* tail, const index_t base) {
+			bitMap_t mask = 0;
+			if (node == head) {
+				node = node->getRightNode(0);
+			}
+			else if (node->baseIndex < base) {
+				const uint64_t offset = static_cast<uint64_t>(base) - static_cast<uint64_t>(node->baseIndex);
+				if (offset < capacity_count) mask = static_cast<bitMap_t>(node->bitMap >> offset);
+				node = node->getRightNode(0);
+			}
+
+			while (node != tail) {
+				const uint64_t offset = static_cast<uint64_t>(node->baseIndex) - static_cast<uint64_t>(base);
+				if (offset >= capacity_count) break;
+				mask |= static_cast<bitMap_t>(node->bitMap << offset);
+				node = node->getRightNode(0);
+			}
+			return mask;
+		}
+
+		/**
+		 * @brief
+		 * @param node
+		 */
+		void removeNode(SkipListNode* node) {
+			if (node->span != 1) node = this->dissolveExtent(node);
+			this->forget(node);
+			this->countElements(node, -static_cast<int64_t>(bits::popcnt(node->bitMap)));
 
+			SkipListNode* left = nullptr, * right = nullptr;
+
+			for (auto i = 0; i <= node->level; ++i) {
+				// every level is doubly linked, so the path is not needed to unlink
+				left = node->getLeftNode(i);
+				right = node->getRightNode(i);
+
+				left->setRightNode(i, right);
+				right->setLeftNode(i, left);
+				// the link of the left neighbour grows over what the link of node covered
+				if constexpr (order_statistics) {
+					if (i != 0) left->countOf(static_cast<uint8_t>(i)) += node->countOf(static_cast<uint8_t>(i));
+				}
+
+				if (this->leftPathNodes[i] == node) this->leftPathNodes[i] = left;
+			}
+
+			if (this->compactCursor == node) this->compactCursor = node->getRightNode(0);
+
+			if (this->isShared(node)) {
+				this->detach(node);
+			}
+			else {
+				node->releaseTower(*this);
+				this->nodePool->deallocate(node);
+				//delete node;
+			}
+			this->tally(&Counters::nodeRemoves);
+			--this->width;
+			++this->version;
+
+			// remind: the path is patched above, so it never holds the removed node
 			constexpr auto minLevel = 6;
 			if (this->level < minLevel) return;
 
-			if (this->width < (1ULL << (this->level - 1))) {
+			// hysteresis: a level is added at 2 ^ level blocks but only dropped below 2 ^ (level - 2),
+			// so a width moving around a power of 2 does not sweep the top level on every insert / remove
+			if (this->width < (1ULL << (this->level - 2))) {
 				this->decreaseLevel();
 			}
 		}
+		/**
+		 * @brief after the sentries were copied from other, point their neighbours back at this object
+		 * @param other the list the sentries came from
+		 */
+		void relinkSentries(BitmappedBlockSkipList& other) {
+			for (int64_t i = 0; i <= this->level; ++i) {
+				const uint8_t l = static_cast<uint8_t>(i);
+				if (this->sentryHead.getRightNode(l) == &other.sentryTail) this->sentryHead.setRightNode(l, &this->sentryTail);
+				if (this->sentryTail.getLeftNode(l) == &other.sentryHead) this->sentryTail.setLeftNode(l, &this->sentryHead);
+
+				this->sentryHead.getRightNode(l)->setLeftNode(l, &this->sentryHead);
+				this->sentryTail.getLeftNode(l)->setRightNode(l, &this->sentryTail);
+			}
+		}
+
+		/**
+		 * @brief free every node and reset to an empty list
+		 */
+		void releaseNodes() {
+			this->orphanPools();
+			this->destroyValues();
+			this->releaseExtents();
+			this->forgetAll();
+
+			// pool nodes own nothing outside the two pools, so whole slabs are given back at once instead of one by one
+			if (this->nodePool != nullptr) this->nodePool->reset();
+			if (this->towerPool != nullptr) this->towerPool->reset();
+
+			// the overflow of the sentries went back with the tower pool
+			this->sentryHead.overflow = nullptr;
+			this->sentryTail.overflow = nullptr;
+			this->sentryHead.level = 0;
+			this->sentryTail.level = 0;
+			this->sentryHead.setRightNode(0, &this->sentryTail);
+			this->sentryTail.setLeftNode(0, &this->sentryHead);
+
+			std::fill_n(this->leftPathNodes, bbsl::max_level, nullptr);
+			this->width = 0;
+			this->level = 0;
+			this->elementCount = 0;
+			this->unaligned = false;
+			this->compactCursor = nullptr;
+			++this->version;
+		}
+
+		/**
+		 * @brief streaming builder for sorted input, links every level in one pass
+		 * node k (1-based) gets level ctz(k), which never exceeds the final list level
+		 */
+		class SortedBuilder {
+		private:
+			BitmappedBlockSkipList* list;
+			SkipListNode* tails[bbsl::max_level];
+			SkipListNode* current = nullptr;
+			uint64_t count = 0;
+
+		public:
+			SortedBuilder(BitmappedBlockSkipList* list) : list(list) {
+				list->releaseNodes();
+				std::fill_n(this->tails, bbsl::max_level, &list->sentryHead);
+			}
+
+			void push(const index_t index, const value_t& value) {
+				SkipListNode* node = this->current;
+				if (node == nullptr || !SkipListNode::isIndexValid(index - node->baseIndex)) {
+					assert((node == nullptr || node->baseIndex < index) && "assign: input must be sorted by index");
+					node = this->appendNode(this->list->baseFor(index, node));
+				}
+				if (node->setElement(static_cast<uint8_t>(index - node->baseIndex), value)) ++this->list->elementCount;
+			}
+
+			/**
+			 * @brief append a block from its packed elements, it must be after every pushed key
+			 * @param baseIndex
+			 * @param bitMap not 0
+			 * @param packed popcnt(bitMap) elements in index order
+			 */
+			void pushPacked(const index_t baseIndex, const bitMap_t bitMap, const value_t* packed) {
+				static_assert(trivial_values, "packed records are assigned into the slots, value_t must be trivial");
+				SkipListNode* node = this->appendNode(baseIndex);
+				if ((baseIndex & static_cast<index_t>(index_align)) != 0) this->list->unaligned = true;
+
+				node->bitMap = bitMap;
+				bitMap_t mask = bitMap;
+				while (mask != 0) {
+					const uint8_t i = bits::ctz(mask);
+					node->elements[i] = *packed++;
+					bits::set_zero(mask, i);
+				}
+				this->list->elementCount += bits::popcnt(bitMap);
+			}
+
+			/**
+			 * @brief append a copy of a whole block, source must be after every pushed key
+			 * @param source
+			 */
+			void pushBlock(const SkipListNode* source) {
+				SkipListNode* node = this->appendNode(source->baseIndex);
+				node->copyElements(*source);
+				this->list->elementCount += bits::popcnt(source->bitMap);
+			}
+
+			/**
+			 * @brief append a whole block, it must be after every pushed key
+			 * @param baseIndex
+			 * @param bitMap not 0
+			 * @param elements capacity_count slots, only the set bits are read
+			 */
+			void pushBlock(const index_t baseIndex, const bitMap_t bitMap, const value_t* elements) {
+				SkipListNode* node = this->appendNode(baseIndex);
+				if ((baseIndex & static_cast<index_t>(index_align)) != 0) this->list->unaligned = true;
+
+				if constexpr (trivial_values) {
+					node->bitMap = bitMap;
+					std::copy_n(elements, capacity_count, node->elements);
+				}
+				else {
+					bitMap_t mask = bitMap;
+					while (mask != 0) {
+						const uint8_t i = bits::ctz(mask);
+						node->emplaceElement(i, elements[i]);
+						bits::set_zero(mask, i);
+					}
+				}
+				this->list->elementCount += bits::popcnt(bitMap);
+			}
+
+			/**
+			 * @brief the last appended block, nullptr before the first
+			 */
+			const SkipListNode* back() const {
+				return this->current;
+			}
+
+			void finish() {
+				SkipListNode* tail = &this->list->sentryTail;
+				// the list keeps width < 2 ^ level
+				uint8_t targetLevel = 0;
+				while ((1ULL << targetLevel) <= this->count) ++targetLevel;
+				while (tail->level < targetLevel) tail->increaseLevel(*this->list);
+				while (this->list->sentryHead.level < targetLevel) this->list->sentryHead.increaseLevel(*this->list);
+
+				for (uint8_t i = 0; i <= targetLevel; ++i) {
+					this->tails[i]->setRightNode(i, tail);
+					tail->setLeftNode(i, this->tails[i]);
+				}
+
+				this->list->width = this->count;
+				this->list->level = targetLevel;
+				this->list->rebuildCounts();
+				++this->list->version;
+			}
+
+		private:
+			SkipListNode* appendNode(const index_t baseIndex) {
+				++this->count;
+				const uint8_t nodeLevel = bits::ctz64(this->count);
+
+				SkipListNode& head = this->list->sentryHead;
+				while (head.level < nodeLevel) head.increaseLevel(*this->list);
+
+				SkipListNode* node = this->list->nodes().allocate(baseIndex, nodeLevel, *this->list);
+				this->list->stamp(node);
+				for (uint8_t i = 0; i <= nodeLevel; ++i) {
+					this->tails[i]->setRightNode(i, node);
+					node->setLeftNode(i, this->tails[i]);
+					this->tails[i] = node;
+				}
+
+				this->current = node;
+				return node;
+			}
+		};
+
+		/**
+		 * @brief move the base of a block up to its first element, the freed front is left to the left block
+		 * @param node must not be empty
+		 */
+		void rebase(SkipListNode* node) {
+			const uint8_t shift = bits::ctz(node->bitMap);
+			if (shift == 0) return;
+
+			this->forget(node);
+			node->shiftElements(shift);
+			node->baseIndex += shift;
+			if ((node->baseIndex & index_align) != 0) this->unaligned = true;
+		}
+
+		/**
+		 * @brief pull the elements of the right neighbours into target while they fit its window
+		 * @param target
+		 * @param threshold a block with at most threshold elements is sparse
+		 * @return the next target
+		 */
+		SkipListNode* repack(SkipListNode* target, const uint8_t threshold) {
+			SkipListNode* source = target->getRightNode(0);
+
+			while (source != &this->sentryTail) {
+				// extents keep their consecutive bases
+				if (target->span != 1 || source->span != 1) return source;
+				if (bits::popcnt(target->bitMap) > threshold && bits::popcnt(source->bitMap) > threshold) return source;
+
+				this->rebase(target);
+				const index_t limit = target->baseIndex + static_cast<index_t>(capacity_count);
+				if (!(source->baseIndex < limit)) {
+					this->rebase(source);
+					if (!(source->baseIndex < limit)) return source;
+				}
+
+				// keys only grow to the right, so the part of source below limit lands above every key of target
+				bitMap_t mask = source->bitMap;
+				if (SkipListNode::isIndexValid(limit - source->baseIndex)) {
+					mask &= bits::mask_below<bitMap_t>(static_cast<uint8_t>(limit - source->baseIndex));
+				}
+				if constexpr (order_statistics) {
+					this->countElements(source, -static_cast<int64_t>(bits::popcnt(mask)));
+					this->countElements(target, bits::popcnt(mask));
+				}
+				while (mask != 0) {
+					const uint8_t i = bits::ctz(mask);
+					const uint8_t offset = static_cast<uint8_t>(source->baseIndex + i - target->baseIndex);
+					target->moveElement(offset, *source, i);
+					bits::set_zero(mask, i);
+				}
+
+				if (!source->isEmpty()) {
+					this->rebase(source);
+					++this->version;
+					return source;
+				}
+
+				SkipListNode* right = source->getRightNode(0);
+				this->removeNode(source);
+				source = right;
+			}
+			return source;
+		}
+
+		/**
+		 * @brief relink every level with deterministic heights, node k (1-based) gets level ctz(k)
+		 * only level 0 has to be linked before the call
+		 */
+		void rebuildTowers() {
+			uint8_t targetLevel = 0;
+			while ((1ULL << targetLevel) <= this->width) ++targetLevel;
+
+			SkipListNode* tails[bbsl::max_level];
+			std::fill_n(tails, bbsl::max_level, &this->sentryHead);
+			while (this->sentryHead.level < targetLevel) this->sentryHead.increaseLevel(*this);
+			while (this->sentryTail.level < targetLevel) this->sentryTail.increaseLevel(*this);
+			this->sentryHead.level = targetLevel;
+			this->sentryTail.level = targetLevel;
+
+			uint64_t count = 0;
+			SkipListNode* node = this->sentryHead.getRightNode(0);
+			while (node != &this->sentryTail) {
+				SkipListNode* right = node->getRightNode(0);
+				// only the head of an extent is counted, the inside stays on level 0
+				const uint8_t nodeLevel = (node->span == 0) ? 0 : bits::ctz64(++count);
+
+				if (nodeLevel >= bbsl::inline_levels) {
+					if (node->overflow == nullptr) node->overflow = static_cast<SkipListNode**>(this->towers().allocate());
+				}
+				else {
+					node->releaseTower(*this);
+				}
+				node->level = nodeLevel;
+
+				for (uint8_t i = 0; i <= nodeLevel; ++i) {
+					tails[i]->setRightNode(i, node);
+					node->setLeftNode(i, tails[i]);
+					tails[i] = node;
+				}
+				node = right;
+			}
+
+			for (uint8_t i = 0; i <= targetLevel; ++i) {
+				tails[i]->setRightNode(i, &this->sentryTail);
+				this->sentryTail.setLeftNode(i, tails[i]);
+			}
+
+			this->level = targetLevel;
+			this->leftPathNodes[0] = nullptr;
+			this->rebuildCounts();
+			++this->version;
+		}
+
+		/**
+		 * @brief replace count pool nodes starting at first by one extent, only level 0 is linked
+		 * the caller must rebuild the towers afterwards
+		 * @param first
+		 * @param count
+		 */
+		void promoteRun(SkipListNode* first, const uint16_t count) {
+			SkipListNode* extent = static_cast<SkipListNode*>(this->acquireExtent(count));
+			if (extent == nullptr) return;// stay on pool nodes
+
+			SkipListNode* left = first->getLeftNode(0);
+			SkipListNode* node = first;
+			for (uint16_t k = 0; k < count; ++k) {
+				SkipListNode* slot = new (extent + k) SkipListNode();
+				slot->baseIndex = node->baseIndex;
+				slot->span = (k == 0) ? count : 0;
+				slot->relocateElements(*node);
+
+				slot->setLeftNode(0, left);
+				left->setRightNode(0, slot);
+				left = slot;
+
+				SkipListNode* right = node->getRightNode(0);
+				this->forget(node);
+				node->releaseTower(*this);
+				this->nodePool->deallocate(node);
+				node = right;
+			}
+			left->setRightNode(0, node);
+			node->setLeftNode(0, left);
+
+			++this->extentCount;
+			this->compactCursor = nullptr;
+		}
+
+		/**
+		 * @brief turn the extent holding node back into pool nodes, every level and the path are kept
+		 * @param node any block of the extent
+		 * @return the pool node that replaced node
+		 */
+		SkipListNode* dissolveExtent(SkipListNode* node) {
+			SkipListNode* head = node;
+			while (head->span == 0) head = head->getLeftNode(0);
+
+			SkipListNode* replaced = nullptr;
+			for (uint16_t k = 0, count = head->span; k < count; ++k) {
+				SkipListNode* block = head + k;
+				SkipListNode* copy = this->nodes().allocate();
+				copy->baseIndex = block->baseIndex;
+				copy->level = block->level;
+				copy->overflow = block->overflow;
+				std::copy_n(block->tower, bbsl::inline_levels * 2, copy->tower);
+				copy->relocateElements(*block);
+
+				// left to right, so the left neighbour is already the copy
+				for (uint8_t i = 0; i <= copy->level; ++i) {
+					copy->getLeftNode(i)->setRightNode(i, copy);
+					copy->getRightNode(i)->setLeftNode(i, copy);
+					if (this->leftPathNodes[i] == block) this->leftPathNodes[i] = copy;
+				}
+				if (this->compactCursor == block) this->compactCursor = copy;
+				if (block == node) replaced = copy;
+				this->forget(block);
+			}
+
+			this->freeExtent(head);
+			++this->version;
+			return replaced;
+		}
+
+		void* acquireExtent(const uint16_t count) {
+			const size_t bytes = sizeof(SkipListNode) * count;
+			if (this->upstream == nullptr) return slab::_malloc(bytes);
+			try {
+				return this->upstream->allocate(bytes, alignof(SkipListNode));
+			}
+			catch (const std::bad_alloc&) {
+				return nullptr;
+			}
+		}
+
+		void freeExtent(SkipListNode* head) {
+			const uint16_t count = head->span;
+			std::destroy_n(head, count);
+			if (this->upstream == nullptr) slab::_free(head);
+			else this->upstream->deallocate(head, sizeof(SkipListNode) * count, alignof(SkipListNode));
+			--this->extentCount;
+		}
+
+		/**
+		 * @brief end the lifetime of every value before the slabs go back at once, nothing to do for trivial values
+		 */
+		void destroyValues() {
+			if constexpr (!trivial_values) {
+				for (SkipListNode* node = this->sentryHead.getRightNode(0); node != &this->sentryTail; node = node->getRightNode(0)) {
+					node->destroyElements(node->bitMap);
+				}
+			}
+		}
+
+		/**
+		 * @brief free every extent, the links are left to the caller
+		 */
+		void releaseExtents() {
+			if (this->extentCount == 0) return;
+
+			SkipListNode* node = this->sentryHead.getRightNode(0);
+			while (node != &this->sentryTail) {
+				SkipListNode* head = node;
+				node = (head->span > 1) ? (head + (head->span - 1))->getRightNode(0) : head->getRightNode(0);
+				if (head->span > 1) this->freeExtent(head);
+			}
+		}
+
 	public:
 		/**
 		 * @brief
 		 * @param invalid invalid value, it should be a default value that is not used in the data
 		 */
-		BitmappedBlockSkipList(const value_t& invalid) {
-			this->invalid = invalid;
+		BitmappedBlockSkipList(const value_t& invalid) : invalid(invalid) {
+
+			this->sentryHead.setRightNode(0, &this->sentryTail);
+			this->sentryTail.setLeftNode(0, &this->sentryHead);
+		}
+
+		/**
+		 * @brief
+		 * @param seed
+		 * @param invalid invalid value, it should be a default value that is not used in the data
+		 */
+		BitmappedBlockSkipList(const value_t& invalid, uint64_t seed) : invalid(invalid) {
+
+			this->sentryHead.setRightNode(0, &this->sentryTail);
+			this->sentryTail.setLeftNode(0, &this->sentryHead);
+
+			rng.seed(seed);
+		}
+
+		/**
+		 * @brief
+		 * @param invalid invalid value, it should be a default value that is not used in the data
+		 * @param upstream memory for the slabs and extents (an arena, huge pages, NUMA local memory), it must outlive the list
+		 */
+		BitmappedBlockSkipList(const value_t& invalid, std::pmr::memory_resource* upstream) : upstream(upstream), invalid(invalid) {
 
 			this->sentryHead.setRightNode(0, &this->sentryTail);
 			this->sentryTail.setLeftNode(0, &this->sentryHead);
 		}
 
+		/**
+		 * @brief deep copy, blocks are cloned in order into fresh pools with perfect tower heights
+		 * like the pmr containers the copy does not inherit the memory resource
+		 * @param other
+		 */
+		BitmappedBlockSkipList(const BitmappedBlockSkipList& other) : BitmappedBlockSkipList(other, nullptr) {}
+
+		/**
+		 * @brief deep copy into pools backed by upstream
+		 * @param other
+		 * @param upstream
+		 */
+		BitmappedBlockSkipList(const BitmappedBlockSkipList& other, std::pmr::memory_resource* upstream) : BitmappedBlockSkipList(other.invalid, upstream) {
+			this->rng = other.rng;
+
+			SortedBuilder builder(this);
+			const SkipListNode* node = other.sentryHead.getRightNode(0);
+			while (node != &other.sentryTail) {
+				builder.pushBlock(node);
+				node = node->getRightNode(0);
+			}
+			builder.finish();
+			this->unaligned = other.unaligned;
+		}
+
+		/**
+		 * @brief O(level) and no allocation, the pools and the sentry links are taken over
+		 * other is left empty without pools, it makes new ones on its next insert
+		 * @param other
+		 */
+		BitmappedBlockSkipList(BitmappedBlockSkipList&& other) noexcept(std::is_nothrow_copy_constructible_v<value_t>&& std::is_nothrow_swappable_v<value_t>)
+			: BitmappedBlockSkipList(other.invalid, other.upstream) {
+			this->swap(other);
+		}
+
+		BitmappedBlockSkipList& operator=(const BitmappedBlockSkipList& other) {
+			if (this != &other) {
+				// keep our own memory resource
+				BitmappedBlockSkipList copy(other, this->upstream);
+				this->swap(copy);
+			}
+			return *this;
+		}
+
+		BitmappedBlockSkipList& operator=(BitmappedBlockSkipList&& other) noexcept(std::is_nothrow_swappable_v<value_t>) {
+			if (this != &other) {
+				this->swap(other);
+				other.clear();
+			}
+			return *this;
+		}
+
+		~BitmappedBlockSkipList() {
+			// the pools free every slab without visiting a node, pool nodes and towers own nothing else
+			static_assert(std::is_trivially_destructible_v<SkipListNode>, "teardown relies on nodes without a destructor");
+			// live snapshots take the pools over, so a snapshot may outlive its list
+			this->orphanPools();
+			this->destroyValues();
+			this->releaseExtents();
+			delete this->nodePool;
+			delete this->towerPool;
+			// no need to free sentry node
+		}
+
+		/**
+		 * @brief exchange the content in O(level), the sentries live inside the object so their neighbours are re-pointed
+		 * @param other
+		 */
+		void swap(BitmappedBlockSkipList& other) noexcept(std::is_nothrow_swappable_v<value_t>) {
+			std::swap(this->nodePool, other.nodePool);
+			std::swap(this->towerPool, other.towerPool);
+			std::swap(this->rng, other.rng);
+			std::swap(this->sentryHead, other.sentryHead);
+			std::swap(this->sentryTail, other.sentryTail);
+			std::swap(this->width, other.width);
+			std::swap(this->elementCount, other.elementCount);
+			std::swap(this->extentCount, other.extentCount);
+			std::swap(this->upstream, other.upstream);
+			std::swap(this->indexCache, other.indexCache);
+			std::swap(this->unaligned, other.unaligned);
+			std::swap(this->compactCursor, other.compactCursor);
+			std::swap(this->registry, other.registry);
+			std::swap(this->generation, other.generation);
+			std::swap(this->detached, other.detached);
+			std::swap(this->detachedCount, other.detachedCount);
+			std::swap(this->reclaimedBelow, other.reclaimedBelow);
+			std::swap(this->level, other.level);
+			std::swap(this->invalid, other.invalid);
+
+			this->relinkSentries(other);
+			other.relinkSentries(*this);
+
+			// fingers of either side must not match the other one
+			const uint64_t version = std::max(this->version, other.version) + 1;
+			this->version = version;
+			other.version = version;
+			std::fill_n(this->leftPathNodes, bbsl::max_level, nullptr);
+			std::fill_n(other.leftPathNodes, bbsl::max_level, nullptr);
+		}
+
+		/**
+		 * @brief remove every element, whole slabs go back to the pools at once
+		 */
+		void clear() {
+			this->releaseNodes();
+		}
+
+		/**
+		 * @brief replace the content with sorted (index, value) pairs in O(n)
+		 * blocks are packed left to right and tower heights are assigned deterministically (perfect skip list)
+		 * @param sortedBegin iterator of pair-like (first = index, second = value), strictly increasing by index
+		 * @param sortedEnd
+		 */
+		template<typename Iter>
+		void assign(Iter sortedBegin, Iter sortedEnd) {
+			SortedBuilder builder(this);
+			for (; sortedBegin != sortedEnd; ++sortedBegin) {
+				builder.push(static_cast<index_t>((*sortedBegin).first), (*sortedBegin).second);
+			}
+			builder.finish();
+		}
+
+		/**
+		 * @brief replace the content with values placed at consecutive indices in O(n)
+		 * @param startIndex index of the first value
+		 * @param valuesBegin
+		 * @param valuesEnd
+		 */
+		template<typename Iter>
+		void assign(const index_t startIndex, Iter valuesBegin, Iter valuesEnd) {
+			SortedBuilder builder(this);
+			index_t index = startIndex;
+			for (; valuesBegin != valuesEnd; ++valuesBegin, ++index) {
+				builder.push(index, *valuesBegin);
+			}
+			builder.finish();
+		}
+
+		/**
+		 * @brief stream every block out in the layout of bbsl::format, open the stream in binary mode
+		 * the record sizes are known up front, so the header already holds the directory offset and nothing is seeked
+		 * @param out
+		 * @return false if the stream failed
+		 */
+		bool serialize(std::ostream& out) const {
+			static_assert(trivial_values, "the records hold raw values, value_t must be trivial");
+			return writeBlocks(out, this->elementCount, [this](auto func) {
+				for (const SkipListNode* node = this->sentryHead.getRightNode(0); node != &this->sentryTail; node = node->getRightNode(0)) {
+					func(node);
+				}
+				});
+		}
+
+		/**
+		 * @brief replace the content with a stream written by serialize, in O(n) without a single descent
+		 * the blocks are appended as they are read, towers are assigned like assign() does
+		 * @param in a binary stream, it is left after the directory
+		 * @return false if the stream is foreign, truncated or inconsistent, the list is empty then
+		 */
+		bool deserialize(std::istream& in) {
+			static_assert(trivial_values, "the records hold raw values, value_t must be trivial");
+			format::FileHeader header;
+			if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || !format::compatible<index_t, value_t, bitMap_t>(header)) {
+				this->clear();
+				return false;
+			}
+
+			SortedBuilder builder(this);
+			const SkipListNode* last = nullptr;
+			value_t packed[capacity_count];
+			bool valid = true;
+
+			for (uint64_t b = 0; b < header.blockCount && valid; ++b) {
+				format::BlockHeader block;
+				if (!in.read(reinterpret_cast<char*>(&block), sizeof(block))) break;
+
+				const bitMap_t bitMap = static_cast<bitMap_t>(block.bitMap);
+				const uint64_t bytes = bits::popcnt(bitMap) * sizeof(value_t);
+				if (bitMap == 0 || block.bitMap != static_cast<uint64_t>(bitMap)) break;
+				if (!in.read(reinterpret_cast<char*>(packed), bytes) || !in.ignore(format::padded(bytes) - bytes)) break;
+
+				// strictly increasing, and the block on the left must not hold an index of this one
+				const index_t base = format::decodeIndex<index_t>(block.baseIndex);
+				if (last != nullptr) {
+					// ordered first, a hostile base must not overflow a signed index_t
+					valid = last->baseIndex < base;
+					if (!valid) break;
+					const uint64_t gap = static_cast<uint64_t>(base) - static_cast<uint64_t>(last->baseIndex);
+					valid = gap >= capacity_count || (static_cast<uint64_t>(last->bitMap) >> gap) == 0;
+					if (!valid) break;
+				}
+
+				builder.pushPacked(base, bitMap, packed);
+				last = builder.back();
+			}
+			builder.finish();
+
+			// the directory is not needed to rebuild, step over it
+			const bool complete = valid && (this->width == header.blockCount) && (this->elementCount == header.elementCount)
+				&& in.ignore(header.blockCount * sizeof(uint64_t) * 2).good();
+			if (!complete) {
+				this->clear();
+				return false;
+			}
+			return true;
+		}
+
+		std::pmr::memory_resource* resource() const {
+			return this->upstream;
+		}
+
+		int64_t getLevel() const {
+			return this->level;
+		}
+
+		/**
+		 * @brief O(1), the count is kept on every bitmap transition
+		 * @return the number of elements
+		 */
+		uint64_t size() const {
+			return this->elementCount;
+		}
+
+		bool empty() const {
+			return this->elementCount == 0;
+		}
+
+		/**
+		 * @brief occupancy report, elements and fill are recounted from the bitmaps
+		 */
+		struct Stats {
+			uint64_t blocks = 0;
+			uint64_t elements = 0;
+			double averageFill = 0;						// elements / (blocks * capacity_count)
+			int64_t level = 0;
+			uint64_t levelHistogram[bbsl::max_level] = { 0 };	// node count by tower height
+			size_t nodeBytes = 0;						// memory held by the node pool
+			size_t towerBytes = 0;						// memory held by the overflow tower pool
+			uint32_t nodeSlabs = 0;
+			uint32_t towerSlabs = 0;
+			uint64_t extents = 0;
+			size_t extentBytes = 0;						// memory held by the extents, outside the pools
+			uint64_t detached = 0;						// blocks out of the list that live snapshots may still read
+			slab::SlabStats nodePool;					// the traffic counters are 0 unless Options::collect_counters
+			slab::SlabStats towerPool;
+		};
+
+		/**
+		 * @brief O(blocks)
+		 * @return
+		 */
+		Stats stats() const {
+			Stats result;
+			result.level = this->level;
+
+			const SkipListNode* node = this->sentryHead.getRightNode(0);
+			while (node != &this->sentryTail) {
+				++result.blocks;
+				result.elements += bits::popcnt64(node->bitMap);
+				++result.levelHistogram[node->level];
+				if (node->span > 1) {
+					++result.extents;
+					result.extentBytes += sizeof(SkipListNode) * node->span;
+				}
+				node = node->getRightNode(0);
+			}
+			assert(result.elements == this->elementCount && "stats: element count is out of sync");
+
+			if (result.blocks != 0) {
+				result.averageFill = static_cast<double>(result.elements) / static_cast<double>(result.blocks * capacity_count);
+			}
+			if (this->nodePool != nullptr) {
+				result.nodeBytes = this->nodePool->bytes();
+				result.nodeSlabs = this->nodePool->total();
+				result.nodePool = this->nodePool->stats();
+			}
+			if (this->towerPool != nullptr) {
+				result.towerBytes = this->towerPool->bytes();
+				result.towerSlabs = this->towerPool->total();
+				result.towerPool = this->towerPool->stats();
+			}
+			result.detached = this->detachedCount;
+			return result;
+		}
+
+		/**
+		 * @brief O(1)
+		 * @return all 0 unless Options::collect_counters
+		 */
+		Counters counters() const {
+			if constexpr (collect_counters) return this->counts;
+			else return Counters();
+		}
+
+		/**
+		 * @brief zero the counters of the list and of its pools
+		 */
+		void resetCounters() {
+			if constexpr (collect_counters) {
+				this->counts = Counters();
+				if (this->nodePool != nullptr) this->nodePool->resetCounters();
+				if (this->towerPool != nullptr) this->towerPool->resetCounters();
+			}
+		}
+
+		/**
+		 * @brief
+		 * @param index
+		 * @return
+		 */
+		bool has(const index_t index) const {
+			if (this->width == 0) return false;
+
+			const SkipListNode* node = this->findFloorNode(index);
+			// now node is the maximum node with baseIndex <= index
+			if (node != &this->sentryHead && node->baseIndex <= index && SkipListNode::isIndexValid(index - node->baseIndex)) {
+				return node->hasElement(index - node->baseIndex);
+			}
+			return false;
+		}
+
+		/**
+		 * @brief merge runs of sparse blocks and rebuild the towers, the pools keep the freed units for reuse
+		 * @param threshold a block with at most threshold elements is merged with its right neighbours
+		 * @return the number of freed blocks
+		 */
+		uint64_t compact(const uint8_t threshold = capacity_count / 2) {
+			// blocks seen by a snapshot must keep their base and content, compaction waits until they are gone
+			if (this->hasLiveSnapshots()) return 0;
+			const uint64_t before = this->width;
+
+			SkipListNode* node = this->sentryHead.getRightNode(0);
+			while (node != &this->sentryTail) {
+				node = this->repack(node, threshold);
+			}
+			this->compactCursor = nullptr;
+
+			if constexpr (Options::extent_blocks != 0) this->promoteExtents(Options::extent_blocks);
+			this->rebuildTowers();
+			return before - this->width;
+		}
+
+		/**
+		 * @brief incremental compact, visits at most budget blocks and continues from there on the next call
+		 * the towers are not rebuilt, removeNode keeps the level in bounds
+		 * @param threshold
+		 * @param budget
+		 * @return true when a whole pass has been finished
+		 */
+		bool compactStep(const uint8_t threshold = capacity_count / 2, uint64_t budget = 64) {
+			if (this->hasLiveSnapshots()) return true;
+			SkipListNode* node = (this->compactCursor != nullptr) ? this->compactCursor : this->sentryHead.getRightNode(0);
+
+			while (node != &this->sentryTail && budget != 0) {
+				node = this->repack(node, threshold);
+				--budget;
+			}
+			this->leftPathNodes[0] = nullptr;
+
+			const bool finished = (node == &this->sentryTail);
+			this->compactCursor = finished ? nullptr : node;
+			return finished;
+		}
+
+		/**
+		 * @brief promote every run of at least minBlocks consecutive full blocks into one extent and rebuild the towers
+		 * extents suit runs that stay dense: emptying any block of one, or a shiftIndices that cuts it,
+		 * turns the whole extent back into span pool nodes, O(span) allocations on what is otherwise a plain erase
+		 * @param minBlocks
+		 * @return the number of new extents
+		 */
+		uint64_t promoteExtents(const uint16_t minBlocks = 8) {
+			if constexpr (snapshots) return 0;
+			const uint64_t before = this->extentCount;
+			const uint16_t minimum = (minBlocks < 2) ? 2 : minBlocks;
+			constexpr uint16_t maximum = UINT16_MAX;
+
+			SkipListNode* node = this->sentryHead.getRightNode(0);
+			while (node != &this->sentryTail) {
+				if (node->span != 1 || node->bitMap != full_mask) {
+					node = node->getRightNode(0);
+					continue;
+				}
+
+				SkipListNode* first = node;
+				uint16_t count = 1;
+				node = node->getRightNode(0);
+				while (node != &this->sentryTail && count < maximum && node->span == 1 && node->bitMap == full_mask
+					&& node->baseIndex == first->baseIndex + static_cast<index_t>(capacity_count) * count) {
+					++count;
+					node = node->getRightNode(0);
+				}
+
+				if (count >= minimum) this->promoteRun(first, count);
+			}
+
+			if (this->extentCount != before) this->rebuildTowers();
+			return this->extentCount - before;
+		}
+
+		/**
+		 * @brief
+		 * @param index
+		 */
+		bool erase(const index_t index) {
+			if (this->width == 0) return false;
+
+			// removeNode does not need the path, so a cached block skips the descent
+			SkipListNode* node = this->cachedNode(index);
+			if (node == nullptr) node = this->findLeftNode(index);
+			// now node is the maximum node with baseIndex <= index
+			if (node != &this->sentryHead && node->baseIndex <= index && SkipListNode::isIndexValid(index - node->baseIndex)) {
+				uint8_t offset = static_cast<uint8_t>(index - node->baseIndex);
+				if (node->hasElement(offset)) {
+					this->eraseElement(node, offset);
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/**
+		 * @brief erase every element with key in [start, end), blocks are cleared by mask and never visited per element
+		 * @param start
+		 * @param end
+		 * @return the number of erased elements
+		 */
+		uint64_t eraseRange(const index_t start, const index_t end) {
+			if (this->width == 0 || !(start < end)) return 0;
+
+			SkipListNode* node = this->findLeftNode(start);
+			if (node == &this->sentryHead) node = node->getRightNode(0);
+
+			uint64_t erased = 0;
+			while (node != &this->sentryTail && node->baseIndex < end) {
+				bitMap_t mask = node->bitMap;
+				if (node->baseIndex < start) {
+					const uint64_t toStart = static_cast<uint64_t>(start) - static_cast<uint64_t>(node->baseIndex);
+					mask = (toStart < capacity_count) ? (mask & bits::mask_from<bitMap_t>(static_cast<uint8_t>(toStart))) : 0;
+				}
+				const uint64_t toEnd = static_cast<uint64_t>(end) - static_cast<uint64_t>(node->baseIndex);
+				if (toEnd < capacity_count) mask &= bits::mask_below<bitMap_t>(static_cast<uint8_t>(toEnd));
+
+				erased += bits::popcnt(mask);
+				node = this->clearMask(node, mask);
+			}
+			return erased;
+		}
+
+		/**
+		 * @brief keep only the keys that other has too, the values of this list stay
+		 * every block is masked with the keys of other in its window, other is searched with a finger from block to block
+		 * @param other
+		 * @return the number of erased elements
+		 */
+		uint64_t intersectKeys(const BitmappedBlockSkipList& other) {
+			if (&other == this) return 0;
+
+			SkipListNode* path[bbsl::max_level] = { nullptr };
+			uint64_t erased = 0;
+			SkipListNode* node = this->sentryHead.getRightNode(0);
+			while (node != &this->sentryTail) {
+				const SkipListNode* floor = other.findLeftNodeFrom(path, node->baseIndex);
+				const bitMap_t mask = node->bitMap & static_cast<bitMap_t>(~keysAt(floor, &other.sentryHead, &other.sentryTail, node->baseIndex));
+				erased += bits::popcnt(mask);
+				node = this->clearMask(node, mask);
+			}
+			return erased;
+		}
+
+		/**
+		 * @brief erase every key that other has, each block of other clears the blocks of this list in its window
+		 * @param other
+		 * @return the number of erased elements
+		 */
+		uint64_t subtract(const BitmappedBlockSkipList& other) {
+			if (&other == this) {
+				const uint64_t erased = this->elementCount;
+				this->clear();
+				return erased;
+			}
+
+			uint64_t erased = 0;
+			for (const SkipListNode* block = other.sentryHead.getRightNode(0); block != &other.sentryTail && this->width != 0; block = block->getRightNode(0)) {
+				SkipListNode* node = this->findLeftNodeFrom(this->leftPathNodes, block->baseIndex);
+				if (node == &this->sentryHead) node = node->getRightNode(0);
+
+				while (node != &this->sentryTail) {
+					// the keys of block in the window of node
+					bitMap_t theirs = 0;
+					if (node->baseIndex <= block->baseIndex) {
+						const uint64_t offset = static_cast<uint64_t>(block->baseIndex) - static_cast<uint64_t>(node->baseIndex);
+						if (offset < capacity_count) theirs = static_cast<bitMap_t>(block->bitMap << offset);
+					}
+					else {
+						const uint64_t offset = static_cast<uint64_t>(node->baseIndex) - static_cast<uint64_t>(block->baseIndex);
+						if (offset >= capacity_count) break;
+						theirs = static_cast<bitMap_t>(block->bitMap >> offset);
+					}
+
+					const bitMap_t mask = node->bitMap & theirs;
+					erased += bits::popcnt(mask);
+					node = this->clearMask(node, mask);
+				}
+			}
+			return erased;
+		}
+
+		/**
+		 * @brief add every element of other, a key both lists have gets merge(mine, theirs)
+		 * a block of other with the base of a block here is merged with | on the bitmaps, a block that lands in a gap is copied whole,
+		 * only a block that straddles blocks of this list or reaches into the right block (unaligned bases) goes element by element
+		 * @param other
+		 * @param merge (mine, theirs) -> value
+		 * @return the number of added elements
+		 */
+		template<typename Merge>
+		uint64_t unionWith(const BitmappedBlockSkipList& other, Merge merge) {
+			if (&other == this) {
+				const BitmappedBlockSkipList copy(other);
+				return this->unionWith(copy, merge);
+			}
+
+			uint64_t added = 0;
+			for (const SkipListNode* block = other.sentryHead.getRightNode(0); block != &other.sentryTail; block = block->getRightNode(0)) {
+				const index_t base = block->baseIndex;
+				SkipListNode* node = this->findLeftNodeFrom(this->leftPathNodes, base);
+
+				// the keys of block must stay below the right block, on an unaligned list it may start inside the window
+				const SkipListNode* right = node->getRightNode(0);
+				const uint64_t toRight = static_cast<uint64_t>(right->baseIndex) - static_cast<uint64_t>(base);
+				const bool gapRight = right == &this->sentryTail || toRight >= capacity_count || (block->bitMap >> toRight) == 0;
+
+				if (node != &this->sentryHead && node->baseIndex == base && gapRight) {
+					node = this->own(node);
+					bitMap_t both = node->bitMap & block->bitMap;
+					while (both != 0) {
+						const uint8_t i = bits::ctz(both);
+						node->elements[i] = merge(node->elements[i], block->elements[i]);
+						bits::set_zero(both, i);
+					}
+
+					bitMap_t fresh = block->bitMap & static_cast<bitMap_t>(~node->bitMap);
+					const uint64_t count = bits::popcnt(fresh);
+					if constexpr (trivial_values) {
+						node->bitMap |= fresh;
+						while (fresh != 0) {
+							const uint8_t i = bits::ctz(fresh);
+							node->elements[i] = block->elements[i];
+							bits::set_zero(fresh, i);
+						}
+					}
+					else {
+						while (fresh != 0) {
+							const uint8_t i = bits::ctz(fresh);
+							node->emplaceElement(i, block->elements[i]);
+							bits::set_zero(fresh, i);
+						}
+					}
+					this->elementCount += count;
+					this->countElements(node, static_cast<int64_t>(count));
+					added += count;
+					continue;
+				}
+
+				// a new block at base must not take keys from the floor block either
+				const uint64_t fromFloor = static_cast<uint64_t>(base) - static_cast<uint64_t>(node->baseIndex);
+				const bool gapLeft = node == &this->sentryHead || fromFloor >= capacity_count || (node->bitMap >> fromFloor) == 0;
+
+				if (!(gapLeft && gapRight)) {
+					bitMap_t mask = block->bitMap;
+					while (mask != 0) {
+						const uint8_t i = bits::ctz(mask);
+						const index_t index = base + i;
+						if (this->has(index)) {
+							value_t& slot = (*this)[index];
+							slot = merge(slot, block->elements[i]);
+						}
+						else {
+							(*this)[index] = block->elements[i];
+							++added;
+						}
+						bits::set_zero(mask, i);
+					}
+					continue;
+				}
+
+				SkipListNode* copy = this->insertNode(base);
+				copy->copyElements(*block);
+				if ((base & index_align) != 0) this->unaligned = true;
+
+				const uint64_t count = bits::popcnt(block->bitMap);
+				this->elementCount += count;
+				this->countElements(copy, static_cast<int64_t>(count));
+				added += count;
+			}
+			return added;
+		}
+
+		/**
+		 * @brief renumber every element with key >= from by delta, for insert / remove at the front or in the middle of an array
+		 * delta > 0 opens the gap [from, from + delta), delta < 0 erases [from + delta, from) and closes it
+		 * the blocks right of from only get a new baseIndex, the block holding keys on both sides of from is split,
+		 * so the cost is one pass over the blocks right of from and the elements of one block
+		 * e.g. unshift k: shiftIndices(0, k), shift: shiftIndices(1, -1), splice: shiftIndices(start + deleted, inserted - deleted)
+		 * @param from
+		 * @param delta no key may leave the range of index_t
+		 * @return the number of blocks that got a new base
+		 */
+		uint64_t shiftIndices(const index_t from, const int64_t delta) {
+			const auto shifted = [delta](const index_t index) {
+				return static_cast<index_t>(static_cast<uint64_t>(index) + static_cast<uint64_t>(delta));
+				};
+			const index_t to = shifted(from);
+			if (delta < 0) this->eraseRange(to, from);
+			if (delta == 0 || this->width == 0) return 0;
+
+			// the last block with a base left of from, it stays where it is
+			SkipListNode* left = this->findLeftNode(from);
+			if (left != &this->sentryHead && left->baseIndex == from) left = left->getLeftNode(0);
+			// an extent keeps consecutive bases, it cannot be cut by the shift
+			if (left != &this->sentryHead && left->span != 1) left = this->dissolveExtent(left);
+
+			SkipListNode* first = left->getRightNode(0);
+			// the block that takes the keys >= from of the straddling block
+			SkipListNode* split = nullptr;
+
+			if (left != &this->sentryHead) {
+				const uint64_t offset = static_cast<uint64_t>(from) - static_cast<uint64_t>(left->baseIndex);
+				const bitMap_t high = (offset < capacity_count) ? (left->bitMap & bits::mask_from<bitMap_t>(static_cast<uint8_t>(offset))) : 0;
+				const uint8_t shift = static_cast<uint8_t>(offset);
+
+				if (high != 0 && high == left->bitMap && delta > 0) {
+					// every key of the block moves, so the whole block does
+					first = left;
+				}
+				else if (high != 0) {
+					left = this->own(left);
+					this->forget(left);
+					if (high == left->bitMap) {
+						// delta < 0 and nothing stays, repack in place onto the new base, the left neighbour ends below it
+						left->shiftElements(shift);
+						left->baseIndex = to;
+						if ((to & index_align) != 0) this->unaligned = true;
+					}
+					else {
+						// the keys >= from leave for a block of their own at the new position
+						// it is linked right after left before anything moves, so a failed allocation loses nothing
+						this->findLeftNode(left->baseIndex);
+						split = this->insertNode(to);
+						bitMap_t mask = high;
+						while (mask != 0) {
+							const uint8_t i = bits::ctz(mask);
+							split->moveElement(static_cast<uint8_t>(i - shift), *left, i);
+							bits::set_zero(mask, i);
+						}
+						this->countElements(left, -static_cast<int64_t>(bits::popcnt(high)));
+						this->countElements(split, bits::popcnt(high));
+					}
+				}
+			}
+
+			uint64_t blocks = 0;
+			for (SkipListNode* node = first; node != &this->sentryTail; node = node->getRightNode(0), ++blocks) {
+				node = this->own(node);
+				node->baseIndex = shifted(node->baseIndex);
+				if ((node->baseIndex & index_align) != 0) this->unaligned = true;
+			}
+
+			// every cached key and path is stale
+			this->forgetAll();
+			this->leftPathNodes[0] = nullptr;
+			++this->version;
+
+			if (split != nullptr) {
+				this->remember(split, to);
+				if ((to & index_align) != 0) this->unaligned = true;
+				++blocks;
+			}
+			return blocks;
+		}
+
+		/**
+		 * @brief
+		 * @param index
+		 * @return
+		 */
+		value_t& operator[](const index_t index) {
+			// quick path: we dont need full node path when setting exist element, so we directly find left node[0] and check
+			SkipListNode* cachedNode = this->leftPathNodes[0];
+			if (this->covers(cachedNode, index)) {
+				this->tally(&Counters::fingerHits);
+				cachedNode = this->own(cachedNode);
+				uint8_t offset = static_cast<uint8_t>(index - cachedNode->baseIndex);
+				if (!cachedNode->hasElement(offset)) {
+					cachedNode->setElement(offset, this->invalid);
+					++this->elementCount;
+					this->countElements(cachedNode, 1);
+				}
+
+				return cachedNode->elements[offset];
+			}
+			this->tally(&Counters::fingerMisses);
+
+			// the block exists, only the path is unknown
+			if constexpr (index_cache_slots != 0) {
+				SkipListNode* hit = this->cachedNode(index);
+				if (hit != nullptr) {
+					hit = this->own(hit);
+					uint8_t offset = static_cast<uint8_t>(index - hit->baseIndex);
+					if (!hit->hasElement(offset)) {
+						hit->setElement(offset, this->invalid);
+						++this->elementCount;
+						this->countElements(hit, 1);
+					}
+
+					return hit->elements[offset];
+				}
+			}
+
+			SkipListNode* node = this->findLeftNode(index);
+
+			if (node != &this->sentryHead && node->baseIndex <= index && SkipListNode::isIndexValid(index - node->baseIndex)) {
+				node = this->own(node);
+				uint8_t offset = static_cast<uint8_t>(index - node->baseIndex);
+				if (!node->hasElement(offset)) {
+					node->setElement(offset, this->invalid);
+					++this->elementCount;
+					this->countElements(node, 1);
+				}
+
+				this->remember(node, index);
+				return node->elements[offset];
+			}
+
+			//align to capacity
+			const index_t baseIndex = this->baseFor(index, node);
+			const uint8_t offsetIndex = static_cast<uint8_t>(index - baseIndex);
+
+			SkipListNode* newNode = this->insertNode(baseIndex);
+			value_t& value = this->fillNewNode(newNode, offsetIndex, this->invalid);
+			this->remember(newNode, index);
+			return value;
+		}
+
+		/**
+		 * @brief construct the element of index in place from args, an existing element is assigned value_t(args...)
+		 * @param index
+		 * @param args
+		 * @return the element
+		 */
+		template <typename... Args>
+		value_t& emplace(const index_t index, Args&&... args) {
+			SkipListNode* node = this->findLeftNodeFrom(this->leftPathNodes, index);
+
+			if (node == &this->sentryHead || !SkipListNode::isIndexValid(index - node->baseIndex)) {
+				SkipListNode* newNode = this->insertNode(this->baseFor(index, node));
+				value_t& value = this->fillNewNode(newNode, static_cast<uint8_t>(index - newNode->baseIndex), std::forward<Args>(args)...);
+				this->remember(newNode, index);
+				return value;
+			}
+
+			node = this->own(node);
+			const uint8_t offset = static_cast<uint8_t>(index - node->baseIndex);
+			if (node->emplaceElement(offset, std::forward<Args>(args)...)) {
+				++this->elementCount;
+				this->countElements(node, 1);
+			}
+			this->remember(node, index);
+			return node->elements[offset];
+		}
+
+		/**
+		 * @brief
+		 * @param index
+		 * @return
+		 */
+		const value_t& operator[](const index_t index) const {
+			// read path never touches member state, so concurrent readers are safe as long as nobody writes
+			const SkipListNode* node = this->findFloorNode(index);
+			if (node != &this->sentryHead && node->baseIndex <= index && SkipListNode::isIndexValid(index - node->baseIndex)) {
+				uint8_t offset = static_cast<uint8_t>(index - node->baseIndex);
+
+				if (node->hasElement(offset)) {
+					return node->elements[offset];
+				}
+			}
+
+			return this->invalid;
+		}
+
+		/**
+		 * @brief immutable form of the list, made by freeze()
+		 * the blocks sit in one array in baseIndex order, so a scan is purely sequential memory,
+		 * and a static B+ tree over the bases (one cache line of keys per node, counted without branches so the compiler
+		 * can use SIMD compares) replaces the pointer chasing descent: the top nodes stay in cache, a lookup touches
+		 * about one line of keys and one line of its block
+		 */
+		class Frozen {
+			friend class BitmappedBlockSkipList;
+		public:
+			// keys per tree node, one cache line of them
+			static constexpr uint64_t fanout = (bbsl::cache_line_size / sizeof(index_t) < 2) ? 2 : bbsl::cache_line_size / sizeof(index_t);
+
+		private:
+			struct Block {
+				bitMap_t bitMap;
+				value_t elements[capacity_count];
+			};
+
+			std::pmr::memory_resource* upstream = nullptr;	// nullptr means aligned new / delete
+			Block* blocks = nullptr;
+			index_t* leaves = nullptr;			// the bases in order, padded to whole nodes with the maximum index
+			index_t* inner = nullptr;			// the internal layers from the root down, fanout separators per node
+			uint64_t blockCount = 0;
+			uint64_t leafNodes = 0;
+			uint64_t innerNodes = 0;
+			uint64_t depth = 0;					// internal layers above the leaves
+			uint64_t elementCount = 0;
+			value_t invalid;
+
+			void* acquire(const size_t bytes) {
+				if (bytes == 0) return nullptr;
+				if (this->upstream != nullptr) return this->upstream->allocate(bytes, bbsl::cache_line_size);
+				return ::operator new(bytes, std::align_val_t(bbsl::cache_line_size));
+			}
+
+			void release(void* memory, const size_t bytes) {
+				if (memory == nullptr) return;
+				if (this->upstream != nullptr) this->upstream->deallocate(memory, bytes, bbsl::cache_line_size);
+				else ::operator delete(memory, std::align_val_t(bbsl::cache_line_size));
+			}
+
+			void releaseAll() {
+				this->release(this->blocks, sizeof(Block) * this->blockCount);
+				this->release(this->leaves, sizeof(index_t) * this->leafNodes * fanout);
+				this->release(this->inner, sizeof(index_t) * this->innerNodes * fanout);
+				this->blocks = nullptr;
+				this->leaves = nullptr;
+				this->inner = nullptr;
+				this->blockCount = this->leafNodes = this->innerNodes = this->depth = this->elementCount = 0;
+			}
+
+			/**
+			 * @brief keys of node <= index, the loop has no branch and a fixed trip count
+			 */
+			static uint64_t countNotAbove(const index_t* node, const index_t index) {
+				uint64_t count = 0;
+				for (uint64_t i = 0; i < fanout; ++i) count += (node[i] <= index) ? 1 : 0;
+				return count;
+			}
+
+			/**
+			 * @brief
+			 * @param index
+			 * @return the position of the last block with base <= index, blockCount if there is none
+			 */
+			uint64_t floorBlock(const index_t index) const {
+				if (this->blockCount == 0) return this->blockCount;
+
+				// child c of node j on the layer below is node j * (fanout + 1) + c
+				uint64_t node = 0;
+				const index_t* layer = this->inner;
+				uint64_t layerNodes = 1;
+				for (uint64_t d = 0; d < this->depth; ++d) {
+					node = node * (fanout + 1) + countNotAbove(layer + node * fanout, index);
+					layer += layerNodes * fanout;
+					layerNodes *= (fanout + 1);
+				}
+
+				// only the maximum index passes the padding, its floor is the last block
+				if (node >= this->leafNodes) return this->blockCount - 1;
+				const uint64_t count = countNotAbove(this->leaves + node * fanout, index);
+				return (count == 0) ? this->blockCount : std::min(node * fanout + count, this->blockCount) - 1;
+			}
+
+			const Block* find(const index_t index, uint8_t& offset) const {
+				const uint64_t position = this->floorBlock(index);
+				if (position == this->blockCount) return nullptr;
+
+				// base <= index, the distance is taken unsigned so a far index cannot overflow
+				const uint64_t distance = static_cast<uint64_t>(index) - static_cast<uint64_t>(this->leaves[position]);
+				if (distance >= capacity_count) return nullptr;
+				offset = static_cast<uint8_t>(distance);
+				const Block* block = this->blocks + position;
+				bitMap_t mask = block->bitMap;
+				return bits::get(mask, offset) ? block : nullptr;
+			}
+
+			/**
+			 * @brief build the search tree over the leaves, layer by layer from the leaves up
+			 */
+			void buildTree() {
+				// the layers needed until one node covers every leaf node
+				uint64_t covered = 1;
+				while (covered < this->leafNodes) {
+					covered *= (fanout + 1);
+					++this->depth;
+				}
+
+				// the layers are complete trees, so node counts are powers of fanout + 1
+				uint64_t layerNodes = 1;
+				for (uint64_t d = 0; d < this->depth; ++d) {
+					this->innerNodes += layerNodes;
+					layerNodes *= (fanout + 1);
+				}
+				this->inner = static_cast<index_t*>(this->acquire(sizeof(index_t) * this->innerNodes * fanout));
+
+				// a separator is the first base of the subtree right of it, missing subtrees use the maximum index
+				index_t* layer = this->inner;
+				layerNodes = 1;
+				uint64_t leavesPerChild = covered / (fanout + 1);
+				for (uint64_t d = 0; d < this->depth; ++d) {
+					for (uint64_t j = 0; j < layerNodes; ++j) {
+						for (uint64_t i = 0; i < fanout; ++i) {
+							const uint64_t firstLeaf = (j * (fanout + 1) + i + 1) * leavesPerChild;
+							layer[j * fanout + i] = (firstLeaf < this->leafNodes) ? this->leaves[firstLeaf * fanout] : std::numeric_limits<index_t>::max();
+						}
+					}
+					layer += layerNodes * fanout;
+					layerNodes *= (fanout + 1);
+					leavesPerChild /= (fanout + 1);
+				}
+			}
+
+			Frozen(const value_t& invalid, std::pmr::memory_resource* upstream) : upstream(upstream), invalid(invalid) {}
+
+		public:
+			Frozen(const Frozen&) = delete;
+			Frozen& operator=(const Frozen&) = delete;
+
+			Frozen(Frozen&& other) noexcept : invalid(other.invalid) {
+				*this = std::move(other);
+			}
+
+			Frozen& operator=(Frozen&& other) noexcept {
+				if (this != &other) {
+					this->releaseAll();
+					this->upstream = other.upstream;
+					this->blocks = other.blocks;
+					this->leaves = other.leaves;
+					this->inner = other.inner;
+					this->blockCount = other.blockCount;
+					this->leafNodes = other.leafNodes;
+					this->innerNodes = other.innerNodes;
+					this->depth = other.depth;
+					this->elementCount = other.elementCount;
+					this->invalid = other.invalid;
+
+					other.blocks = nullptr;
+					other.leaves = nullptr;
+					other.inner = nullptr;
+					other.blockCount = other.leafNodes = other.innerNodes = other.depth = other.elementCount = 0;
+				}
+				return *this;
+			}
+
+			~Frozen() {
+				this->releaseAll();
+			}
+
+			/**
+			 * @brief O(1)
+			 * @return the number of elements
+			 */
+			uint64_t size() const {
+				return this->elementCount;
+			}
+
+			uint64_t blockSize() const {
+				return this->blockCount;
+			}
+
+			/**
+			 * @brief memory of the blocks and the search tree
+			 */
+			size_t bytes() const {
+				return sizeof(Block) * this->blockCount + sizeof(index_t) * (this->leafNodes + this->innerNodes) * fanout;
+			}
+
+			bool has(const index_t index) const {
+				uint8_t offset;
+				return this->find(index, offset) != nullptr;
+			}
+
+			/**
+			 * @brief O(log blocks / log fanout)
+			 * @param index
+			 * @return the element, or the invalid value
+			 */
+			const value_t& operator[](const index_t index) const {
+				uint8_t offset = 0;
+				const Block* block = this->find(index, offset);
+				return (block != nullptr) ? block->elements[offset] : this->invalid;
+			}
+
+			/**
+			 * @brief
+			 * @param func (value, index)
+			 */
+			template<typename Func>
+			void forEach(Func func) const {
+				for (uint64_t b = 0; b < this->blockCount; ++b) {
+					const Block& block = this->blocks[b];
+					const index_t base = this->leaves[b];
+					bitMap_t mask = block.bitMap;
+					while (mask != 0) {
+						const uint8_t i = bits::ctz(mask);
+						func(block.elements[i], base + i);
+						bits::set_zero(mask, i);
+					}
+				}
+			}
+
+			/**
+			 * @brief visit [start, end) in index order after one search
+			 * @param func (value, index)
+			 */
+			template<typename Func>
+			void forEachInRange(const index_t start, const index_t end, Func func) const {
+				if (this->blockCount == 0 || !(start < end)) return;
+
+				uint64_t b = this->floorBlock(start);
+				if (b == this->blockCount) b = 0;
+				for (; b < this->blockCount && this->leaves[b] < end; ++b) {
+					const Block& block = this->blocks[b];
+					const index_t base = this->leaves[b];
+
+					bitMap_t mask = block.bitMap;
+					if (base < start) {
+						const uint64_t toStart = static_cast<uint64_t>(start) - static_cast<uint64_t>(base);
+						mask = (toStart < capacity_count) ? (mask & bits::mask_from<bitMap_t>(static_cast<uint8_t>(toStart))) : 0;
+					}
+					const uint64_t toEnd = static_cast<uint64_t>(end) - static_cast<uint64_t>(base);
+					if (toEnd < capacity_count) mask &= bits::mask_below<bitMap_t>(static_cast<uint8_t>(toEnd));
+					while (mask != 0) {
+						const uint8_t i = bits::ctz(mask);
+						func(block.elements[i], base + i);
+						bits::set_zero(mask, i);
+					}
+				}
+			}
+
+			/**
+			 * @brief back to the mutable form, O(n) with perfect towers
+			 * @param upstream the memory resource of the new list
+			 * @return
+			 */
+			BitmappedBlockSkipList thaw(std::pmr::memory_resource* upstream = nullptr) const {
+				BitmappedBlockSkipList list(this->invalid, upstream);
+				SortedBuilder builder(&list);
+				for (uint64_t b = 0; b < this->blockCount; ++b) {
+					builder.pushBlock(this->leaves[b], this->blocks[b].bitMap, this->blocks[b].elements);
+				}
+				builder.finish();
+				return list;
+			}
+		};
+
+		/**
+		 * @brief O(n), an immutable copy for data that is built once and then only read, the list is unchanged
+		 * extents and unaligned blocks are kept as they are
+		 * @return
+		 */
+		Frozen freeze() const {
+			static_assert(trivial_values, "frozen blocks are copied as a whole, value_t must be trivial");
+			Frozen frozen(this->invalid, this->upstream);
+
+			uint64_t count = 0;
+			for (const SkipListNode* node = this->sentryHead.getRightNode(0); node != &this->sentryTail; node = node->getRightNode(0)) ++count;
+
+			frozen.blockCount = count;
+			frozen.leafNodes = (count + Frozen::fanout - 1) / Frozen::fanout;
+			frozen.elementCount = this->elementCount;
+			frozen.blocks = static_cast<typename Frozen::Block*>(frozen.acquire(sizeof(typename Frozen::Block) * count));
+			frozen.leaves = static_cast<index_t*>(frozen.acquire(sizeof(index_t) * frozen.leafNodes * Frozen::fanout));
+
+			uint64_t b = 0;
+			for (const SkipListNode* node = this->sentryHead.getRightNode(0); node != &this->sentryTail; node = node->getRightNode(0), ++b) {
+				frozen.blocks[b].bitMap = node->bitMap;
+				std::copy_n(node->elements, capacity_count, frozen.blocks[b].elements);
+				frozen.leaves[b] = node->baseIndex;
+			}
+			std::fill(frozen.leaves + count, frozen.leaves + frozen.leafNodes * Frozen::fanout, std::numeric_limits<index_t>::max());
+
+			frozen.buildTree();
+			return frozen;
+		}
+
+		/**
+		 * @brief read-only view of the list at the time snapshot() was taken, it can be read on any thread while the list is written
+		 * it points into the blocks of the list, a write copies a shared block first, so the view never changes
+		 * it may be dropped on any thread and may outlive the list, the pools are handed to it then
+		 */
+		class Snapshot {
+			friend class BitmappedBlockSkipList;
+		private:
+			SnapshotRegistry* registry = nullptr;
+			SnapshotState* state = nullptr;
+			value_t invalid;
+
+			Snapshot(SnapshotRegistry* registry, SnapshotState* state, const value_t& invalid) : registry(registry), state(state), invalid(invalid) {}
+
+			/**
+			 * @brief
+			 * @param index
+			 * @return the position of the last block with base <= index, blockCount if there is none
+			 */
+			uint64_t floorBlock(const index_t index) const {
+				const SkipListNode* const* nodes = this->state->nodes;
+				const SkipListNode* const* end = nodes + this->state->blockCount;
+				const SkipListNode* const* upper = std::upper_bound(nodes, end, index, [](const index_t index, const SkipListNode* node) {
+					return index < node->baseIndex;
+					});
+				return (upper == nodes) ? this->state->blockCount : static_cast<uint64_t>(upper - nodes) - 1;
+			}
+
+			const value_t* find(const index_t index) const {
+				if (this->state == nullptr) return nullptr;
+				const uint64_t position = this->floorBlock(index);
+				if (position == this->state->blockCount) return nullptr;
+
+				const SkipListNode* node = this->state->nodes[position];
+				// base <= index, the distance is taken unsigned so a far index cannot overflow
+				const uint64_t distance = static_cast<uint64_t>(index) - static_cast<uint64_t>(node->baseIndex);
+				if (distance >= capacity_count) return nullptr;
+				return node->hasElement(static_cast<uint8_t>(distance)) ? &node->elements[distance] : nullptr;
+			}
+
+			void release() {
+				if (this->state == nullptr) return;
+				{
+					std::lock_guard<std::mutex> guard(this->registry->lock);
+					SnapshotState* state = this->state;
+					if (state->older != nullptr) state->older->newer = state->newer;
+					else this->registry->oldestState = state->newer;
+					if (state->newer != nullptr) state->newer->older = state->older;
+					else this->registry->newestState = state->older;
+
+					// the blocks only this view saw are not shared anymore, the list stops copying them
+					const SnapshotState* newest = this->registry->newestState;
+					this->registry->newest.store((newest != nullptr) ? newest->generation : 0, std::memory_order_release);
+				}
+				delete[] this->state->nodes;
+				delete this->state;
+				SnapshotRegistry::release(this->registry);
+				this->state = nullptr;
+				this->registry = nullptr;
+			}
+
+		public:
+			Snapshot(const Snapshot&) = delete;
+			Snapshot& operator=(const Snapshot&) = delete;
+
+			Snapshot(Snapshot&& other) noexcept : registry(other.registry), state(other.state), invalid(other.invalid) {
+				other.registry = nullptr;
+				other.state = nullptr;
+			}
+
+			Snapshot& operator=(Snapshot&& other) noexcept {
+				if (this != &other) {
+					this->release();
+					this->registry = other.registry;
+					this->state = other.state;
+					this->invalid = other.invalid;
+					other.registry = nullptr;
+					other.state = nullptr;
+				}
+				return *this;
+			}
+
+			~Snapshot() {
+				this->release();
+			}
+
+			/**
+			 * @brief O(1)
+			 * @return the number of elements
+			 */
+			uint64_t size() const {
+				return (this->state != nullptr) ? this->state->elementCount : 0;
+			}
+
+			uint64_t blockSize() const {
+				return (this->state != nullptr) ? this->state->blockCount : 0;
+			}
+
+			bool has(const index_t index) const {
+				return this->find(index) != nullptr;
+			}
+
+			/**
+			 * @brief O(log blocks), one binary search over the captured blocks
+			 * @param index
+			 * @return the element, or the invalid value
+			 */
+			const value_t& operator[](const index_t index) const {
+				const value_t* value = this->find(index);
+				return (value != nullptr) ? *value : this->invalid;
+			}
+
+			/**
+			 * @brief
+			 * @param func (value, index)
+			 */
+			template<typename Func>
+			void forEach(Func func) const {
+				for (uint64_t b = 0; b < this->blockSize(); ++b) {
+					const SkipListNode* node = this->state->nodes[b];
+					bitMap_t mask = node->bitMap;
+					while (mask != 0) {
+						const uint8_t i = bits::ctz(mask);
+						func(node->elements[i], node->baseIndex + i);
+						bits::set_zero(mask, i);
+					}
+				}
+			}
+
+			/**
+			 * @brief visit [start, end) in index order after one binary search
+			 * @param func (value, index)
+			 */
+			template<typename Func>
+			void forEachInRange(const index_t start, const index_t end, Func func) const {
+				if (this->blockSize() == 0 || !(start < end)) return;
+
+				uint64_t b = this->floorBlock(start);
+				if (b == this->state->blockCount) b = 0;
+				for (; b < this->state->blockCount && this->state->nodes[b]->baseIndex < end; ++b) {
+					const SkipListNode* node = this->state->nodes[b];
+					const index_t base = node->baseIndex;
+
+					bitMap_t mask = node->bitMap;
+					if (base < start) {
+						const uint64_t toStart = static_cast<uint64_t>(start) - static_cast<uint64_t>(base);
+						mask = (toStart < capacity_count) ? (mask & bits::mask_from<bitMap_t>(static_cast<uint8_t>(toStart))) : 0;
+					}
+					const uint64_t toEnd = static_cast<uint64_t>(end) - static_cast<uint64_t>(base);
+					if (toEnd < capacity_count) mask &= bits::mask_below<bitMap_t>(static_cast<uint8_t>(toEnd));
+					while (mask != 0) {
+						const uint8_t i = bits::ctz(mask);
+						func(node->elements[i], base + i);
+						bits::set_zero(mask, i);
+					}
+				}
+			}
+
+			/**
+			 * @brief the same bytes BitmappedBlockSkipList::serialize would have written when the snapshot was taken
+			 * @param out
+			 * @return false if the stream failed
+			 */
+			bool serialize(std::ostream& out) const {
+				return writeBlocks(out, this->size(), [this](auto func) {
+					for (uint64_t b = 0; b < this->blockSize(); ++b) func(this->state->nodes[b]);
+					});
+			}
+		};
+
+		/**
+		 * @brief O(blocks) pointer copies and no element copy, the blocks are shared until the list writes them
+		 * sharing is O(1), one generation bump makes every block older than the snapshot; the pass only fills its directory,
+		 * the snapshot is searched on other threads while the owner relinks the levels, so it cannot walk the links of the list
+		 * a write through operator[], setValue, setMany or forEachBlock copies a shared block once, an erase may copy it,
+		 * so a reference into the list taken before snapshot() must not be written through after it,
+		 * an iterator finds the copy of its block by its key while the snapshots that saw the old block live
+		 * compaction is skipped while a snapshot is alive, requires Options::snapshots
+		 * @return
+		 */
+		Snapshot snapshot() {
+			static_assert(snapshots, "enable Options::snapshots to take snapshots");
+			if (this->registry == nullptr) this->registry = new SnapshotRegistry();
+			this->reclaimDetached();
+
+			SnapshotState* state = new SnapshotState();
+			state->nodes = new const SkipListNode*[this->width];
+			for (const SkipListNode* node = this->sentryHead.getRightNode(0); node != &this->sentryTail; node = node->getRightNode(0)) {
+				state->nodes[state->blockCount++] = node;
+			}
+			state->elementCount = this->elementCount;
+			// every block in the list now is older than the snapshot, new and copied blocks are stamped with the new generation
+			state->generation = ++this->generation;
+
+			{
+				std::lock_guard<std::mutex> guard(this->registry->lock);
+				state->older = this->registry->newestState;
+				if (state->older != nullptr) state->older->newer = state;
+				else this->registry->oldestState = state;
+				this->registry->newestState = state;
+				this->registry->newest.store(state->generation, std::memory_order_release);
+			}
+			this->registry->references.fetch_add(1, std::memory_order_relaxed);
+			return Snapshot(this->registry, state, this->invalid);
+		}
+
+		/**
+		 * @brief caller owned finger for the read path, keep one per thread to share a list between readers
+		 * it remembers the last block and is dropped automatically after a structural change
+		 */
+		class ReadFinger {
+			friend class BitmappedBlockSkipList;
+		private:
+			const SkipListNode* node = nullptr;
+			uint64_t version = 0;
+
+		public:
+			void reset() {
+				this->node = nullptr;
+			}
+		};
+
+	protected:
+		/**
+		 * @brief findFloorNode through a caller owned finger
+		 * @param index
+		 * @param finger
+		 * @return
+		 */
+		const SkipListNode* findFloorNode(const index_t index, ReadFinger& finger) const {
+			const SkipListNode* cached = finger.node;
+			if (finger.version == this->version && this->covers(cached, index)) {
+				return cached;
+			}
+
+			const SkipListNode* node = this->findFloorNode(index);
+			finger.node = (node != &this->sentryHead) ? node : nullptr;
+			finger.version = this->version;
+			return node;
+		}
+
+	public:
+		/**
+		 * @brief same as const operator[], but tries the block remembered by finger before descending
+		 * @param index
+		 * @param finger
+		 * @return
+		 */
+		const value_t& get(const index_t index, ReadFinger& finger) const {
+			const SkipListNode* node = this->findFloorNode(index, finger);
+			if (node != &this->sentryHead && node->baseIndex <= index && SkipListNode::isIndexValid(index - node->baseIndex)) {
+				uint8_t offset = static_cast<uint8_t>(index - node->baseIndex);
+
+				if (node->hasElement(offset)) {
+					return node->elements[offset];
+				}
+			}
+
+			return this->invalid;
+		}
+
+		/**
+		 * @brief same as has(index), but tries the block remembered by finger before descending
+		 * @param index
+		 * @param finger
+		 * @return
+		 */
+		bool has(const index_t index, ReadFinger& finger) const {
+			if (this->width == 0) return false;
+
+			const SkipListNode* node = this->findFloorNode(index, finger);
+			if (node != &this->sentryHead && node->baseIndex <= index && SkipListNode::isIndexValid(index - node->baseIndex)) {
+				return node->hasElement(index - node->baseIndex);
+			}
+			return false;
+		}
+
+		/**
+		 * @brief batched lookup, the descent path is reused between keys (finger search)
+		 * any order is correct, sorted or nearly sorted keys only climb as high as the distance needs
+		 * @param keys
+		 * @param count
+		 * @param out receives the value, or invalid for a hole
+		 */
+		void getMany(const index_t* keys, const size_t count, value_t* out) const {
+			// the path lives on the stack, so batched readers are as safe as the plain read path
+			SkipListNode* path[bbsl::max_level] = { nullptr };
+
+			for (size_t k = 0; k < count; ++k) {
+				const index_t index = keys[k];
+				const SkipListNode* node = this->findLeftNodeFrom(path, index);
+
+				out[k] = this->invalid;
+				if (node != &this->sentryHead && SkipListNode::isIndexValid(index - node->baseIndex)) {
+					node->getElement(static_cast<uint8_t>(index - node->baseIndex), out[k]);
+				}
+			}
+		}
+
+		/**
+		 * @brief batched write, same as operator[](keys[k]) = values[k] with finger search between keys
+		 * @param keys
+		 * @param values
+		 * @param count
+		 */
+		void setMany(const index_t* keys, const value_t* values, const size_t count) {
+			for (size_t k = 0; k < count; ++k) {
+				const index_t index = keys[k];
+				SkipListNode* node = this->findLeftNodeFrom(this->leftPathNodes, index);
+
+				if (node == &this->sentryHead || !SkipListNode::isIndexValid(index - node->baseIndex)) {
+					node = this->insertNode(this->baseFor(index, node));
+					this->fillNewNode(node, static_cast<uint8_t>(index - node->baseIndex), values[k]);
+					continue;
+				}
+
+				node = this->own(node);
+				if (node->setElement(static_cast<uint8_t>(index - node->baseIndex), values[k])) {
+					++this->elementCount;
+					this->countElements(node, 1);
+				}
+			}
+		}
+
+		/**
+		 * @brief batched erase with finger search between keys
+		 * @param keys
+		 * @param count
+		 * @return the number of erased elements
+		 */
+		size_t eraseMany(const index_t* keys, const size_t count) {
+			if (this->width == 0) return 0;
+
+			size_t erased = 0;
+			for (size_t k = 0; k < count; ++k) {
+				const index_t index = keys[k];
+				SkipListNode* node = this->findLeftNodeFrom(this->leftPathNodes, index);
+
+				if (node != &this->sentryHead && SkipListNode::isIndexValid(index - node->baseIndex)) {
+					uint8_t offset = static_cast<uint8_t>(index - node->baseIndex);
+					if (node->hasElement(offset)) {
+						this->eraseElement(node, offset);
+						++erased;
+					}
+				}
+			}
+			return erased;
+		}
+
+	public:
+		template<typename Func>
+		void forEach(Func func) const {
+			SkipListNode* node = this->sentryHead.getRightNode(0);
+			ScanAhead ahead(node, &this->sentryTail);
+			while (node != nullptr && node != &this->sentryTail) {
+				for (int8_t i = SkipListNode::begin(node); i != -1; i = SkipListNode::next(node, i)) {
+					func(node->elements[i], node->baseIndex + i);
+				}
+				ahead.step();
+				node = node->getRightNode(0);
+			}
+		}
+
+		template<typename Func>
+		bool some(Func func) const {
+			SkipListNode* node = this->sentryHead.getRightNode(0);
+			ScanAhead ahead(node, &this->sentryTail);
+			while (node != nullptr && node != &this->sentryTail) {
+				for (int8_t i = SkipListNode::begin(node); i != -1; i = SkipListNode::next(node, i)) {
+					if (func(node->elements[i], node->baseIndex + i)) return true;
+				}
+				ahead.step();
+				node = node->getRightNode(0);
+			}
+			return false;
+		}
+
+		template<typename Func>
+		bool every(Func func) const {
+			SkipListNode* node = this->sentryHead.getRightNode(0);
+			ScanAhead ahead(node, &this->sentryTail);
+			while (node != nullptr && node != &this->sentryTail) {
+				for (int8_t i = SkipListNode::begin(node); i != -1; i = SkipListNode::next(node, i)) {
+					if (!func(node->elements[i], node->baseIndex + i)) return false;
+				}
+				ahead.step();
+				node = node->getRightNode(0);
+			}
+			return true;
+		}
+
+		/**
+		 * @brief visit the elements with key in [start, end)
+		 */
+		template<typename Func>
+		void forEachInRange(const index_t start, const index_t end, Func func) const {
+			this->visitRange(start, end, [&func](const value_t& value, const index_t index) {
+				func(value, index);
+				return true;
+				});
+		}
+
+		template<typename Func>
+		bool someInRange(const index_t start, const index_t end, Func func) const {
+			return !this->visitRange(start, end, [&func](const value_t& value, const index_t index) {
+				return !func(value, index);
+				});
+		}
+
+		template<typename Func>
+		bool everyInRange(const index_t start, const index_t end, Func func) const {
+			return this->visitRange(start, end, [&func](const value_t& value, const index_t index) {
+				return static_cast<bool>(func(value, index));
+				});
+		}
+
+		/**
+		 * @brief visit every block in key order, element i of a block is present when bit i of bitMap is set
+		 * @param func void(index_t baseIndex, bitMap_t bitMap, const value_t* elements), elements has capacity_count slots
+		 */
+		template<typename Func>
+		void forEachBlock(Func func) const {
+			const SkipListNode* node = this->sentryHead.getRightNode(0);
+			ScanAhead ahead(node, &this->sentryTail);
+			while (node != &this->sentryTail) {
+				func(node->baseIndex, node->bitMap, static_cast<const value_t*>(node->elements));
+				ahead.step();
+				node = node->getRightNode(0);
+			}
+		}
+
+		/**
+		 * @brief mutable version, writing a slot whose bit is clear does not make it present
+		 * @param func void(index_t baseIndex, bitMap_t bitMap, value_t* elements)
+		 */
+		template<typename Func>
+		void forEachBlock(Func func) {
+			SkipListNode* node = this->sentryHead.getRightNode(0);
+			ScanAhead ahead(node, &this->sentryTail);
+			while (node != &this->sentryTail) {
+				// func may write any slot, so every shared block is copied
+				node = this->own(node);
+				func(node->baseIndex, node->bitMap, static_cast<value_t*>(node->elements));
+				// a copied block ahead leaves its old node on the detached chain, the look-ahead must not follow it
+				if constexpr (!snapshots) ahead.step();
+				node = node->getRightNode(0);
+			}
+		}
+
+		/**
+		 * @brief block-wise reduction, op must be associative and commutative
+		 * each slot of a block owns a lane accumulator, so a full block is one vertical vector op
+		 * and a partial block is the same op with the identity selected into its holes, the compiler turns both into SIMD
+		 * (SSE/AVX2/AVX-512/NEON, whatever the target enables), lanes are folded once at the end
+		 * @param identity
+		 * @param op acc_t(acc_t, acc_t)
+		 * @return
+		 */
+		template<typename acc_t, typename Op>
+		acc_t reduce(const acc_t identity, Op op) const {
+			return reduceRun(identity, op, this->sentryHead.getRightNode(0), &this->sentryTail);
+		}
+
+		/**
+		 * @brief
+		 * @tparam acc_t accumulator type, use a wider one when the sum may overflow value_t
+		 * @return
+		 */
+		template<typename acc_t = value_t>
+		acc_t sum() const {
+			return this->reduce(static_cast<acc_t>(0), [](const acc_t a, const acc_t b) { return a + b; });
+		}
+
+		/**
+		 * @brief
+		 * @return the minimum element, or invalid when the list is empty
+		 */
+		value_t min() const {
+			if (this->width == 0) return this->invalid;
+			return this->reduce(std::numeric_limits<value_t>::max(), [](const value_t a, const value_t b) { return (b < a) ? b : a; });
+		}
+
 		/**
 		 * @brief
-		 * @param seed
-		 * @param invalid invalid value, it should be a default value that is not used in the data
+		 * @return the maximum element, or invalid when the list is empty
 		 */
-		BitmappedBlockSkipList(const value_t& invalid, uint64_t seed) {
-			this->invalid = invalid;
-
-			this->sentryHead.setRightNode(0, &this->sentryTail);
-			this->sentryTail.setLeftNode(0, &this->sentryHead);
-
-			rng.seed(seed);
-		}
-
-		~BitmappedBlockSkipList() {
-			// release one by one
-			SkipListNode* node = this->sentryHead.getRightNode(0);
-			while (node != nullptr && node != &this->sentryTail) {
-				SkipListNode* next = node->getRightNode(0);
-				this->nodePool.deallocate(node);
-				//delete node;
-				node = next;
-			}
-			// no need to free sentry node
+		value_t max() const {
+			if (this->width == 0) return this->invalid;
+			return this->reduce(std::numeric_limits<value_t>::lowest(), [](const value_t a, const value_t b) { return (a < b) ? b : a; });
 		}
 
-		int64_t getLevel() {
-			return this->level;
+		/**
+		 * @brief
+		 * @return the number of elements, same as size()
+		 */
+		uint64_t count() const {
+			return this->size();
 		}
 
 		/**
-		 * @brief
+		 * @brief O(log blocks) with Options::order_statistics, the descent adds up the counts of the links it takes,
+		 * otherwise O(blocks) on level 0
 		 * @param index
-		 * @return
+		 * @return the number of elements with key < index
 		 */
-		bool has(const index_t index) const {
-			if (this->width == 0) return false;
+		uint64_t rank(const index_t index) const {
+			const SkipListNode* node = &this->sentryHead;
+			int64_t curLevel = order_statistics ? this->level : 0;
+			uint64_t before = 0;
 
-			SkipListNode* node = this->findLeftNode(index);
-			// now node is the maximum node with baseIndex <= index
-			if (node != &this->sentryHead && node->baseIndex <= index && SkipListNode::isIndexValid(index - node->baseIndex)) {
-				return node->hasElement(index - node->baseIndex);
+			while (curLevel >= 0) {
+				const uint8_t l = static_cast<uint8_t>(curLevel);
+				const SkipListNode* next = node->getRightNode(l);
+				if (next != &this->sentryTail && next->baseIndex <= index) {
+					before += linkCount(node, l);
+					node = next;
+				}
+				else {
+					--curLevel;
+				}
 			}
-			return false;
+
+			if (node == &this->sentryHead) return before;
+			if (!SkipListNode::isIndexValid(index - node->baseIndex)) return before + bits::popcnt(node->bitMap);
+			return before + bits::popcnt(static_cast<bitMap_t>(node->bitMap & bits::mask_below<bitMap_t>(static_cast<uint8_t>(index - node->baseIndex))));
 		}
 
+	protected:
 		/**
-		 * @brief
-		 * @param index
+		 * @brief the lane reduction of reduce() over the blocks [node, last) of level 0
 		 */
-		bool erase(const index_t index) {
-			if (this->width == 0) return false;
+		template<typename acc_t, typename Op>
+		static acc_t reduceRun(const acc_t identity, Op& op, const SkipListNode* node, const SkipListNode* last) {
+			acc_t lanes[capacity_count];
+			std::fill_n(lanes, capacity_count, identity);
 
-			SkipListNode* node = this->findLeftNode(index);
-			// now node is the maximum node with baseIndex <= index
-			if (node != &this->sentryHead && node->baseIndex <= index && SkipListNode::isIndexValid(index - node->baseIndex)) {
-				uint8_t offset = static_cast<uint8_t>(index - node->baseIndex);
-				if (node->hasElement(offset)) {
-					node->deleteElement(offset);
+			ScanAhead ahead(node, last);
+			while (node != last) {
+				const value_t* elements = node->elements;
+				const bitMap_t mask = node->bitMap;
 
-					//remove node
-					if (node->isEmpty()) this->removeNode(node);
-					return true;
+				if (mask == full_mask) {
+					for (uint64_t i = 0; i < capacity_count; ++i) {
+						lanes[i] = op(lanes[i], static_cast<acc_t>(elements[i]));
+					}
 				}
+				else if constexpr (!trivial_values) {
+					// the holes hold no object
+					bitMap_t live = mask;
+					while (live != 0) {
+						const uint8_t i = bits::ctz(live);
+						lanes[i] = op(lanes[i], static_cast<acc_t>(elements[i]));
+						bits::set_zero(live, i);
+					}
+				}
+				else {
+					// a hole feeds the identity, its slot may hold an erased value or slab bytes that op must never see
+					for (uint64_t i = 0; i < capacity_count; ++i) {
+						lanes[i] = op(lanes[i], ((mask >> i) & 1) ? static_cast<acc_t>(elements[i]) : identity);
+					}
+				}
+				ahead.step();
+				node = node->getRightNode(0);
 			}
-			return false;
+
+			acc_t result = identity;
+			for (uint64_t i = 0; i < capacity_count; ++i) {
+				result = op(result, lanes[i]);
+			}
+			return result;
 		}
 
 		/**
-		 * @brief
-		 * @param index
-		 * @return
+		 * @brief level 0 cut into runs, run i is [starts[i], starts[i + 1]) and starts[runs] is the tail
 		 */
-		value_t& operator[](const index_t index) {
-			// quick path: we dont need full node path when setting exist element, so we directly find left node[0] and check
-			SkipListNode* cachedNode = this->leftPathNodes[0];
-			if (cachedNode != nullptr && cachedNode != &this->sentryHead && cachedNode->baseIndex <= index && SkipListNode::isIndexValid(index - cachedNode->baseIndex)) {
-				uint8_t offset = static_cast<uint8_t>(index - cachedNode->baseIndex);
-				if (!cachedNode->hasElement(offset)) {
-					cachedNode->setElement(offset, this->invalid);
-				}
+		struct Partition {
+			const SkipListNode** starts = nullptr;
+			uint64_t runs = 0;
+			uint32_t workers = 0;
 
-				return cachedNode->elements[offset];
+			Partition() = default;
+			Partition(const Partition&) = delete;
+			Partition& operator=(const Partition&) = delete;
+
+			~Partition() {
+				delete[] this->starts;
 			}
+		};
 
-			SkipListNode* node = this->findLeftNode(index);
+		/**
+		 * @brief cut at the nodes of the lowest level that still has a few of them per worker, no pass over level 0
+		 * @param executor
+		 * @param part empty for an empty list
+		 */
+		template<typename Executor>
+		void partition(const Executor& executor, Partition& part) const {
+			if (this->width == 0) return;
+			part.workers = std::max<uint32_t>(1, executor.concurrency());
 
-			if (node != &this->sentryHead && node->baseIndex <= index && SkipListNode::isIndexValid(index - node->baseIndex)) {
-				uint8_t offset = static_cast<uint8_t>(index - node->baseIndex);
-				if (!node->hasElement(offset)) {
-					node->setElement(offset, this->invalid);
-				}
+			// several runs per worker since the tower heights are random and so are the run lengths, about width / 2^k nodes reach level k
+			const uint64_t wanted = static_cast<uint64_t>(part.workers) * 8;
+			int64_t k = 0;
+			while (k < this->level && (this->width >> (k + 1)) >= wanted) ++k;
 
-				return node->elements[offset];
+			const SkipListNode* first = this->sentryHead.getRightNode(0);
+			part.runs = 1;
+			for (const SkipListNode* node = this->sentryHead.getRightNode(k); node != &this->sentryTail; node = node->getRightNode(k)) {
+				if (node != first) ++part.runs;
 			}
 
-			//align to capacity
-			const index_t offsetIndex = index & index_align;
-
-			SkipListNode* newNode = this->insertNode(index - offsetIndex);
-			newNode->setElement(offsetIndex, this->invalid);
-			return newNode->elements[offsetIndex];
+			part.starts = new const SkipListNode*[part.runs + 1];
+			uint64_t i = 0;
+			part.starts[i++] = first;
+			for (const SkipListNode* node = this->sentryHead.getRightNode(k); node != &this->sentryTail; node = node->getRightNode(k)) {
+				if (node != first) part.starts[i++] = node;
+			}
+			part.starts[part.runs] = &this->sentryTail;
 		}
 
 		/**
-		 * @brief
-		 * @param index
-		 * @return
+		 * @brief a worker takes the next free run until none is left, so a slow run only holds up its own worker
+		 * @param visit bool(uint64_t run, const SkipListNode* node, const SkipListNode* last, const std::atomic<bool>& stop),
+		 * false cancels the runs not started yet, a long run should poll stop
+		 * @return false if a visit cancelled
 		 */
-		const value_t& operator[](const index_t index) const {
-			// quick path: we dont need full node path when setting exist element, so we directly find left node[0] and check
-			SkipListNode* cachedNode = this->leftPathNodes[0];
-			if (cachedNode != nullptr && cachedNode != &this->sentryHead && cachedNode->baseIndex <= index && SkipListNode::isIndexValid(index - cachedNode->baseIndex)) {
-				uint8_t offset = static_cast<uint8_t>(index - cachedNode->baseIndex);
+		template<typename Executor, typename Visit>
+		static bool runParallel(const Executor& executor, const Partition& part, Visit visit) {
+			if (part.runs == 0) return true;
 
-				if (cachedNode->hasElement(offset)) {
-					return cachedNode->elements[offset];
+			std::atomic<uint64_t> next{ 0 };
+			std::atomic<bool> stop{ false };
+			auto job = [&](uint32_t) {
+				try {
+					for (uint64_t run = next.fetch_add(1, std::memory_order_relaxed); run < part.runs; run = next.fetch_add(1, std::memory_order_relaxed)) {
+						if (stop.load(std::memory_order_relaxed)) return;
+						if (!visit(run, part.starts[run], part.starts[run + 1], stop)) stop.store(true, std::memory_order_relaxed);
+					}
 				}
-			}
-
-			SkipListNode* node = this->findLeftNode(index);
-			if (node != &this->sentryHead && node->baseIndex <= index && SkipListNode::isIndexValid(index - node->baseIndex)) {
-				uint8_t offset = static_cast<uint8_t>(index - node->baseIndex);
-
-				if (node->hasElement(offset)) {
-					return node->elements[offset];
+				catch (...) {
+					// the other workers give up at their next run, the executor rethrows
+					stop.store(true, std::memory_order_relaxed);
+					throw;
 				}
-			}
-
-			return this->invalid;
+				};
+			executor.run(static_cast<uint32_t>(std::min<uint64_t>(part.workers, part.runs)), job);
+			return !stop.load(std::memory_order_relaxed);
 		}
 
 	public:
-		template<typename Func>
-		void forEach(Func func) const {
-			SkipListNode* node = this->sentryHead.getRightNode(0);
-			while (node != nullptr && node != &this->sentryTail) {
-				for (int8_t i = SkipListNode::begin(node); i != -1; i = SkipListNode::next(node, i)) {
-					func(node->elements[i], node->baseIndex + i);
+		/**
+		 * @brief forEach on several threads, the runs between the towers of an upper level are the units of work
+		 * blocks are visited in order inside a run, runs in no particular order, the list must not be written meanwhile
+		 * @param func (value, index), called concurrently, it must be thread safe, an exception cancels the other runs and is rethrown
+		 * @param executor see bbsl::ThreadExecutor
+		 */
+		template<typename Func, typename Executor = bbsl::ThreadExecutor>
+		void parallelForEach(Func func, const Executor& executor = Executor()) const {
+			Partition part;
+			this->partition(executor, part);
+			runParallel(executor, part, [&func](uint64_t, const SkipListNode* node, const SkipListNode* last, const std::atomic<bool>&) {
+				ScanAhead ahead(node, last);
+				while (node != last) {
+					for (int8_t i = SkipListNode::begin(node); i != -1; i = SkipListNode::next(node, i)) {
+						func(node->elements[i], node->baseIndex + i);
+					}
+					ahead.step();
+					node = node->getRightNode(0);
 				}
-				node = node->getRightNode(0);
-			}
+				return true;
+				});
 		}
 
-		template<typename Func>
-		bool some(Func func) const {
-			SkipListNode* node = this->sentryHead.getRightNode(0);
-			while (node != nullptr && node != &this->sentryTail) {
-				for (int8_t i = SkipListNode::begin(node); i != -1; i = SkipListNode::next(node, i)) {
-					if (func(node->elements[i], node->baseIndex + i)) return true;
-				}
-				node = node->getRightNode(0);
-			}
-			return false;
+		/**
+		 * @brief reduce() on several threads, every run is reduced on its own and the partials are folded in index order
+		 * @param identity
+		 * @param op acc_t(acc_t, acc_t), associative and commutative, called concurrently
+		 * @param executor see bbsl::ThreadExecutor
+		 * @return
+		 */
+		template<typename acc_t, typename Op, typename Executor = bbsl::ThreadExecutor>
+		acc_t parallelReduce(const acc_t identity, Op op, const Executor& executor = Executor()) const {
+			Partition part;
+			this->partition(executor, part);
+			std::unique_ptr<acc_t[]> partials(new acc_t[part.runs]);
+			runParallel(executor, part, [&](uint64_t run, const SkipListNode* node, const SkipListNode* last, const std::atomic<bool>&) {
+				partials[run] = reduceRun(identity, op, node, last);
+				return true;
+				});
+
+			acc_t result = identity;
+			for (uint64_t run = 0; run < part.runs; ++run) result = op(result, partials[run]);
+			return result;
 		}
 
-		template<typename Func>
-		bool every(Func func) const {
-			SkipListNode* node = this->sentryHead.getRightNode(0);
-			while (node != nullptr && node != &this->sentryTail) {
-				for (int8_t i = SkipListNode::begin(node); i != -1; i = SkipListNode::next(node, i)) {
-					if (!func(node->elements[i], node->baseIndex + i)) return false;
+		/**
+		 * @brief some() on several threads, a hit cancels the other workers at their next block
+		 * @param func bool(value, index), called concurrently
+		 * @param executor see bbsl::ThreadExecutor
+		 */
+		template<typename Func, typename Executor = bbsl::ThreadExecutor>
+		bool parallelSome(Func func, const Executor& executor = Executor()) const {
+			Partition part;
+			this->partition(executor, part);
+			const bool none = runParallel(executor, part, [&func](uint64_t, const SkipListNode* node, const SkipListNode* last, const std::atomic<bool>& stop) {
+				while (node != last && !stop.load(std::memory_order_relaxed)) {
+					for (int8_t i = SkipListNode::begin(node); i != -1; i = SkipListNode::next(node, i)) {
+						if (func(node->elements[i], node->baseIndex + i)) return false;
+					}
+					node = node->getRightNode(0);
 				}
-				node = node->getRightNode(0);
-			}
-			return true;
+				return true;
+				});
+			return !none;
 		}
 
-		class IterObject {
-		private:
-			BitmappedBlockSkipList* skiplist = nullptr;
-			SkipListNode* node = nullptr;
-			int8_t inside_index = 0;
+		/**
+		 * @brief every() on several threads, a miss cancels the other workers at their next block
+		 * @param func bool(value, index), called concurrently
+		 * @param executor see bbsl::ThreadExecutor
+		 */
+		template<typename Func, typename Executor = bbsl::ThreadExecutor>
+		bool parallelEvery(Func func, const Executor& executor = Executor()) const {
+			return !this->parallelSome([&func](const value_t& value, const index_t index) {
+				return !func(value, index);
+				}, executor);
+		}
 
+		/**
+		 * @brief bidirectional iterator over the elements in index order, *it is the value and key() its index
+		 * end() is the tail sentry, so stepping checks one node pointer and never nullptr
+		 * @tparam isConst the const form reads a const list and converts from the mutable one
+		 */
+		template <bool isConst>
+		class BasicIterObject {
+			friend class BitmappedBlockSkipList;
+			friend class BasicIterObject<!isConst>;
 		public:
-			IterObject() = delete;
-			IterObject(BitmappedBlockSkipList* skiplist, SkipListNode* node, int8_t inside_index)
+			using iterator_category = std::bidirectional_iterator_tag;
+			using value_type = value_t;
+			using difference_type = std::ptrdiff_t;
+			using pointer = std::conditional_t<isConst, const value_t*, value_t*>;
+			using reference = std::conditional_t<isConst, const value_t&, value_t&>;
+
+			/**
+			 * @brief key/value proxy, the value refers into the block
+			 */
+			struct Entry {
+				index_t key;
+				reference value;
+			};
+
+		private:
+			using list_t = std::conditional_t<isConst, const BitmappedBlockSkipList, BitmappedBlockSkipList>;
+			using node_t = std::conditional_t<isConst, const SkipListNode, SkipListNode>;
+
+			list_t* skiplist = nullptr;
+			// a write through a mutable iterator may swap a block shared with a snapshot for its copy
+			mutable node_t* node = nullptr;
+			mutable int8_t inside_index = 0;
+
+			BasicIterObject(list_t* skiplist, node_t* node, int8_t inside_index)
 				: skiplist(skiplist), node(node), inside_index(inside_index) {
 			}
 
-			~IterObject() = default;
+			bool atEnd() const {
+				return this->node == &this->skiplist->sentryTail;
+			}
+
+			/**
+			 * @brief a block copied or removed for a snapshot left the list, move on to the block that holds the key now
+			 * @return false if no block of the list covers the key anymore
+			 */
+			bool settle() const {
+				if constexpr (snapshots) {
+					if (!this->node->retired) return true;
+
+					const index_t index = this->node->baseIndex + this->inside_index;
+					node_t* floor = this->skiplist->findFloorNode(index);
+					if (floor == &this->skiplist->sentryHead || !SkipListNode::isIndexValid(index - floor->baseIndex)) return false;
+					this->node = floor;
+					this->inside_index = static_cast<int8_t>(index - floor->baseIndex);
+				}
+				return true;
+			}
+
+		public:
+			// a default iterator is singular, it may only be assigned to
+			BasicIterObject() = default;
+
+			template <bool wasConst, typename = std::enable_if_t<isConst && !wasConst>>
+			BasicIterObject(const BasicIterObject<wasConst>& other)
+				: skiplist(other.skiplist), node(other.node), inside_index(other.inside_index) {
+			}
+
+			/**
+			 * @brief the iterator must point at an element, a mutable one copies a block shared with a snapshot first
+			 * it cannot tell a read from a write, so read through a const_iterator to keep the blocks shared
+			 */
+			reference operator*() const {
+				this->settle();
+				if constexpr (!isConst) this->node = this->skiplist->own(this->node);
+				return this->node->elements[this->inside_index];
+			}
+
+			pointer operator->() const {
+				return &**this;
+			}
 
-			const value_t& operator*() const {
-				// we don't know if user will call operator* when the node is deleted, so we return invalid in this case
-				return node->hasElement(inside_index) ? node->elements[inside_index] : skiplist->invalid;
+			Entry entry() const {
+				return Entry{ this->key(), **this };
 			}
 
 			index_t key() const {
-				return (this->node != nullptr) ? (this->node->baseIndex + this->inside_index) : 0;
+				return this->atEnd() ? 0 : (this->node->baseIndex + this->inside_index);
 			}
 
+			/**
+			 * @brief write the slot of the iterator, it stays valid even if the element was erased since
+			 * @param value
+			 * @return false at end()
+			 */
+			template <bool constSelf = isConst, typename = std::enable_if_t<!constSelf>>
 			bool setValue(const value_t& value) {
-				if (this->node == nullptr) return false;
-				this->node->setElement(this->inside_index, value);
+				if (this->atEnd()) return false;
+				if (!this->settle()) {
+					// the block went with its last element, the key gets a new one
+					(*this->skiplist)[this->key()] = value;
+					this->settle();
+					return true;
+				}
+				this->node = this->skiplist->own(this->node);
+				if (this->node->setElement(this->inside_index, value)) {
+					++this->skiplist->elementCount;
+					this->skiplist->countElements(this->node, 1);
+				}
 				return true;
 			}
 
-			IterObject& operator++() {
-				if (this->node == nullptr) return *this;
+			BasicIterObject& operator++() {
+				if constexpr (snapshots) {
+					// the links of a retired block are gone, step on from the key in the list
+					if (this->node->retired) {
+						const index_t index = this->key();
+						*this = lowerBoundOf<BasicIterObject>(this->skiplist, index);
+						if (this->atEnd() || this->key() != index) return *this;
+					}
+				}
 				int8_t nextIndex = SkipListNode::next(this->node, this->inside_index);
 
 				if (nextIndex == -1) {
+					// empty nodes are always removed, so a node other than the tail has a first element
 					this->node = this->node->getRightNode(0);
-					if (this->node != nullptr && this->node != &this->skiplist->sentryTail) {
-						this->inside_index = SkipListNode::begin(this->node);
+					if (this->atEnd()) {
+						this->inside_index = 0;
 					}
 					else {
-						this->node = nullptr;
-						this->inside_index = 0;
+						// an iterator has no room for a cursor, so it only looks one node ahead
+						if constexpr (Options::prefetch_distance > 0) prefetchNode(this->node->getRightNode(0));
+						this->inside_index = SkipListNode::begin(this->node);
 					}
 				}
 				else {
@@ -604,18 +4027,23 @@ namespace bbsl {
 				return *this;
 			}
 
-			IterObject& operator--() {
-				if (this->node == nullptr) return *this;
-				int8_t prevIndex = SkipListNode::prev(this->node, this->inside_index);
+			BasicIterObject operator++(int) {
+				BasicIterObject old = *this;
+				++*this;
+				return old;
+			}
+
+			/**
+			 * @brief end() steps to the last element, begin() must not be decremented
+			 */
+			BasicIterObject& operator--() {
+				if constexpr (snapshots) {
+					if (this->node->retired) *this = lowerBoundOf<BasicIterObject>(this->skiplist, this->key());
+				}
+				int8_t prevIndex = this->atEnd() ? -1 : SkipListNode::prev(this->node, this->inside_index);
 				if (prevIndex == -1) {
 					this->node = this->node->getLeftNode(0);
-					if (this->node != nullptr && this->node != &this->skiplist->sentryHead) {
-						this->inside_index = SkipListNode::end(this->node);
-					}
-					else {
-						this->node = nullptr;
-						this->inside_index = 0;
-					}
+					this->inside_index = SkipListNode::end(this->node);
 				}
 				else {
 					this->inside_index = prevIndex;
@@ -623,48 +4051,173 @@ namespace bbsl {
 				return *this;
 			}
 
-			bool operator==(const IterObject& other) const {
-				return this->skiplist == other.skiplist && this->node == other.node && this->inside_index == other.inside_index;
+			BasicIterObject operator--(int) {
+				BasicIterObject old = *this;
+				--*this;
+				return old;
+			}
+
+			bool operator==(const BasicIterObject& other) const {
+				if (this->node == other.node) return this->inside_index == other.inside_index;
+				if constexpr (snapshots) {
+					// one side may still hold the block the other one replaced by its copy, a retired block is never the end
+					if (this->node->retired || other.node->retired) return !this->atEnd() && !other.atEnd() && this->key() == other.key();
+				}
+				return false;
 			}
 
-			bool operator!=(const IterObject& other) const {
+			bool operator!=(const BasicIterObject& other) const {
 				return !(*this == other);
 			}
 
 			explicit operator bool() const {
-				return this->node != nullptr;
+				return !this->atEnd();
 			}
 		};
 
-		IterObject begin() {
-			SkipListNode* node = this->sentryHead.getRightNode(0);
+		using IterObject = BasicIterObject<false>;
+		using ConstIterObject = BasicIterObject<true>;
+		using iterator = IterObject;
+		using const_iterator = ConstIterObject;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+	protected:
+		template <typename Iter, typename List>
+		static Iter firstOf(List* list, decltype(Iter::node) node) {
+			if (node == &list->sentryTail) return Iter(list, node, 0);
+			return Iter(list, node, SkipListNode::begin(node));
+		}
 
-			if (node == &this->sentryTail) {
-				return IterObject(this, nullptr, 0);
+		template <typename Iter, typename List>
+		static Iter lowerBoundOf(List* list, const index_t index) {
+			if (list->width == 0) return Iter(list, &list->sentryTail, 0);
+
+			decltype(Iter::node) node = list->findFloorNode(index);
+			if (node != &list->sentryHead && SkipListNode::isIndexValid(index - node->baseIndex)) {
+				const bitMap_t mask = node->bitMap & bits::mask_from<bitMap_t>(static_cast<uint8_t>(index - node->baseIndex));
+				if (mask != 0) return Iter(list, node, bits::ctz(mask));
 			}
-			else {
-				return IterObject(this, node, SkipListNode::begin(node));
+
+			// empty nodes are always removed, so the right node must have an element
+			return firstOf<Iter>(list, node->getRightNode(0));
+		}
+
+		template <typename Iter, typename List>
+		static Iter nthOf(List* list, uint64_t k) {
+			if (k >= list->elementCount) return Iter(list, &list->sentryTail, 0);
+
+			decltype(Iter::node) node = &list->sentryHead;
+			int64_t curLevel = order_statistics ? list->level : 0;
+
+			while (curLevel >= 0) {
+				const uint8_t l = static_cast<uint8_t>(curLevel);
+				// k < size, so a link that does not reach past k never ends at the tail
+				const uint64_t skipped = linkCount(node, l);
+				if (skipped <= k) {
+					k -= skipped;
+					node = node->getRightNode(l);
+				}
+				else {
+					--curLevel;
+				}
 			}
+
+			// the k-th set bit of the block
+			bitMap_t mask = node->bitMap;
+			for (; k != 0; --k) mask &= static_cast<bitMap_t>(mask - 1);
+			return Iter(list, node, bits::ctz(mask));
 		}
 
-		IterObject end() {
-			return IterObject(this, nullptr, 0);
+	public:
+		iterator begin() {
+			return firstOf<iterator>(this, this->sentryHead.getRightNode(0));
 		}
 
-		// reverse
-		IterObject rbegin() {
-			SkipListNode* node = this->sentryTail.getLeftNode(0);
+		const_iterator begin() const {
+			return firstOf<const_iterator>(this, this->sentryHead.getRightNode(0));
+		}
 
-			if (node == &this->sentryHead) {
-				return IterObject(this, nullptr, 0);
-			}
-			else {
-				return IterObject(this, node, SkipListNode::end(node));
-			}
+		const_iterator cbegin() const {
+			return this->begin();
+		}
+
+		iterator end() {
+			return iterator(this, &this->sentryTail, 0);
+		}
+
+		const_iterator end() const {
+			return const_iterator(this, &this->sentryTail, 0);
+		}
+
+		const_iterator cend() const {
+			return this->end();
+		}
+
+		/**
+		 * @brief
+		 * @param index
+		 * @return iterator to the first element with key >= index, or end()
+		 */
+		iterator lowerBound(const index_t index) {
+			return lowerBoundOf<iterator>(this, index);
+		}
+
+		const_iterator lowerBound(const index_t index) const {
+			return lowerBoundOf<const_iterator>(this, index);
+		}
+
+		/**
+		 * @brief
+		 * @param index
+		 * @return iterator to the first element with key > index, or end()
+		 */
+		iterator upperBound(const index_t index) {
+			if (index == std::numeric_limits<index_t>::max()) return this->end();
+			return this->lowerBound(index + 1);
+		}
+
+		const_iterator upperBound(const index_t index) const {
+			if (index == std::numeric_limits<index_t>::max()) return this->end();
+			return this->lowerBound(index + 1);
+		}
+
+		/**
+		 * @brief O(log blocks) with Options::order_statistics, otherwise O(blocks), the inverse of rank()
+		 * @param k 0-based position in index order
+		 * @return iterator to the k-th element, or end() if k >= size()
+		 */
+		iterator nth(const uint64_t k) {
+			return nthOf<iterator>(this, k);
+		}
+
+		const_iterator nth(const uint64_t k) const {
+			return nthOf<const_iterator>(this, k);
+		}
+
+		// reverse, ++ walks towards lower indices
+		reverse_iterator rbegin() {
+			return reverse_iterator(this->end());
+		}
+
+		const_reverse_iterator rbegin() const {
+			return const_reverse_iterator(this->end());
+		}
+
+		const_reverse_iterator crbegin() const {
+			return this->rbegin();
+		}
+
+		reverse_iterator rend() {
+			return reverse_iterator(this->begin());
+		}
+
+		const_reverse_iterator rend() const {
+			return const_reverse_iterator(this->begin());
 		}
 
-		IterObject rend() {
-			return IterObject(this, nullptr, 0);
+		const_reverse_iterator crend() const {
+			return this->rend();
 		}
 	};
-}
\ No newline at end of file
+}
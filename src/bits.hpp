@@ -44,6 +44,22 @@ namespace bits {
 		return (value >> bitIdx) & static_cast<T>(1);
 	}
 
+	/**
+	 * @brief mask of all bits at position >= bitIdx
+	 */
+	template<typename T>
+	static inline T mask_from(uint8_t bitIdx) noexcept {
+		return (bitIdx >= sizeof(T) * 8) ? static_cast<T>(0) : static_cast<T>(~static_cast<uint64_t>(0) << bitIdx);
+	}
+
+	/**
+	 * @brief mask of all bits at position < bitIdx
+	 */
+	template<typename T>
+	static inline T mask_below(uint8_t bitIdx) noexcept {
+		return (bitIdx >= sizeof(T) * 8) ? static_cast<T>(~static_cast<T>(0)) : static_cast<T>((static_cast<uint64_t>(1) << bitIdx) - 1);
+	}
+
 	static inline uint8_t popcnt64(uint64_t x) {
 #if defined(__clang__) || defined(__GNUC__)  
 		// GCC / Clang / Linux / macOS / iOS / Android  
@@ -104,4 +120,25 @@ namespace bits {
 		return n;
 #endif
 	}
+
+	/**
+	 * @brief width-relative helpers, so bitmaps narrower than 64 bits do not need to correct the result manually
+	 */
+	template<typename T>
+	static inline uint8_t ctz(T x) {
+		static_assert(std::is_unsigned_v<T> && sizeof(T) <= 8, "bitmap must be an unsigned integer up to 64 bits");
+		return x ? ctz64(x) : static_cast<uint8_t>(sizeof(T) * 8);
+	}
+
+	template<typename T>
+	static inline uint8_t clz(T x) {
+		static_assert(std::is_unsigned_v<T> && sizeof(T) <= 8, "bitmap must be an unsigned integer up to 64 bits");
+		return static_cast<uint8_t>(clz64(x) - (64 - sizeof(T) * 8));
+	}
+
+	template<typename T>
+	static inline uint8_t popcnt(T x) {
+		static_assert(std::is_unsigned_v<T> && sizeof(T) <= 8, "bitmap must be an unsigned integer up to 64 bits");
+		return popcnt64(x);
+	}
 }
\ No newline at end of file
@@ -0,0 +1,484 @@
+/*
+ * MIT License
+ * Copyright (c) 2026 IMSDcrueoft (https://github.com/IMSDcrueoft)
+ * See LICENSE file in the root directory for full license text.
+*/
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <functional>
+
+#include "./bbsl.hpp"
+
+namespace bbsl {
+	/**
+	 * @brief epoch based reclamation, a reader announces the global epoch while it may hold node pointers
+	 * a node retired in epoch e is freed once every announced epoch is > e
+	 */
+	class EpochDomain {
+	public:
+		static constexpr size_t max_readers = 128;	// concurrent guards, a guard waits for a free slot beyond that
+
+	private:
+		struct alignas(bbsl::cache_line_size) Slot {
+			std::atomic<uint64_t> epoch{ 0 };		// 0 means quiescent
+		};
+
+		std::atomic<uint64_t> global{ 1 };
+		Slot slots[max_readers];
+
+	public:
+		class Guard {
+			friend class EpochDomain;
+		private:
+			Slot* slot;
+
+			Guard(Slot* slot) : slot(slot) {}
+
+		public:
+			Guard(const Guard&) = delete;
+			Guard& operator=(const Guard&) = delete;
+
+			~Guard() {
+				this->slot->epoch.store(0, std::memory_order_release);
+			}
+		};
+
+		/**
+		 * @brief pin the current epoch until the guard is destroyed
+		 * @return
+		 */
+		Guard pin() {
+			// start where this thread found a slot the last time, so threads rarely contend on one slot
+			static thread_local size_t hint = std::hash<std::thread::id>()(std::this_thread::get_id()) % max_readers;
+
+			for (;;) {
+				for (size_t probe = 0; probe < max_readers; ++probe) {
+					Slot* slot = &this->slots[(hint + probe) % max_readers];
+					uint64_t expected = 0;
+					if (slot->epoch.load(std::memory_order_relaxed) == 0 && slot->epoch.compare_exchange_strong(expected, this->global.load(std::memory_order_seq_cst), std::memory_order_seq_cst)) {
+						hint = (hint + probe) % max_readers;
+						// the announcement must be visible before the first node pointer is loaded
+						std::atomic_thread_fence(std::memory_order_seq_cst);
+						return Guard(slot);
+					}
+				}
+				std::this_thread::yield();
+			}
+		}
+
+		/**
+		 * @brief tag for a node that was just unlinked, then move the global epoch on
+		 * @return
+		 */
+		uint64_t retireEpoch() {
+			return this->global.fetch_add(1, std::memory_order_seq_cst);
+		}
+
+		/**
+		 * @brief every node retired in an epoch below the result can be freed
+		 * @return
+		 */
+		uint64_t safeEpoch() const {
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			uint64_t minimum = this->global.load(std::memory_order_seq_cst);
+			for (const Slot& slot : this->slots) {
+				const uint64_t epoch = slot.epoch.load(std::memory_order_seq_cst);
+				if (epoch != 0 && epoch < minimum) minimum = epoch;
+			}
+			return minimum;
+		}
+	};
+
+	/**
+	 *  Concurrent sibling of BitmappedBlockSkipList for one shared array with several writers and many readers.
+	 *
+	 *  Readers never lock, they walk the towers with acquire loads inside an epoch guard.
+	 *  Writing or erasing a slot of an existing block is an atomic store plus an atomic OR / AND on the bitmap.
+	 *  Only inserting and removing blocks take the structure mutex, which also owns both pools,
+	 *  and a removed block is freed once no reader that could still see it is left.
+	 *
+	 *  Blocks are always aligned to index_align and the level only grows.
+	 */
+	template <typename index_t, typename value_t, typename bitMap_t = uint16_t>
+	class ConcurrentBitmappedBlockSkipList {
+		static_assert(std::is_integral_v<index_t>, "index_t must be an integral type");
+		static_assert(std::is_trivially_copyable_v<value_t>, "value_t must be trivially copyable to be stored atomically");
+		static_assert(std::is_unsigned_v<bitMap_t> && sizeof(bitMap_t) <= 8, "bitMap_t must be uint8_t, uint16_t, uint32_t or uint64_t");
+
+	public:
+		static constexpr uint8_t capacity_count = sizeof(bitMap_t) * 8; //Capacity of elements in each block
+		static constexpr uint64_t index_align = (capacity_count - 1); // Align to capacity limit
+
+	protected:
+		struct SkipListNode {
+			static constexpr size_t overflow_size = sizeof(std::atomic<SkipListNode*>) * (bbsl::max_level - bbsl::inline_levels);
+
+			index_t baseIndex;
+			std::atomic<bitMap_t> bitMap{ 0 };
+			std::atomic<bool> dead{ false };			//set while the structure mutex is about to unlink the node
+			uint8_t level;
+
+			std::atomic<SkipListNode*> tower[bbsl::inline_levels];	//forward links only, the writer finds predecessors by a search
+			std::atomic<SkipListNode*>* overflow = nullptr;
+
+			SkipListNode* retiredNext = nullptr;		//the retired list is owned by the structure mutex
+			uint64_t retiredEpoch = 0;
+
+			std::atomic<value_t> elements[capacity_count];
+
+		public:
+			SkipListNode(const index_t baseIndex, const uint8_t level, slab::SlabAllocator<>& towerPool) : baseIndex(baseIndex), level(level) {
+				for (auto& link : this->tower) link.store(nullptr, std::memory_order_relaxed);
+				if (level >= bbsl::inline_levels) {
+					this->overflow = static_cast<std::atomic<SkipListNode*>*>(towerPool.allocate());
+					for (uint8_t i = 0; i < bbsl::max_level - bbsl::inline_levels; ++i) {
+						new (this->overflow + i) std::atomic<SkipListNode*>(nullptr);
+					}
+				}
+			}
+
+			void releaseTower(slab::SlabAllocator<>& towerPool) {
+				if (this->overflow != nullptr) {
+					towerPool.deallocate(this->overflow);
+					this->overflow = nullptr;
+				}
+			}
+
+			std::atomic<SkipListNode*>& link(const uint8_t level) {
+				return (level < bbsl::inline_levels) ? this->tower[level] : this->overflow[level - bbsl::inline_levels];
+			}
+
+			const std::atomic<SkipListNode*>& link(const uint8_t level) const {
+				return (level < bbsl::inline_levels) ? this->tower[level] : this->overflow[level - bbsl::inline_levels];
+			}
+
+			SkipListNode* getRightNode(const uint8_t level) const {
+				return this->link(level).load(std::memory_order_acquire);
+			}
+
+			// release, so a reader that sees the node also sees everything written into it before publishing
+			void setRightNode(const uint8_t level, SkipListNode* node) {
+				this->link(level).store(node, std::memory_order_release);
+			}
+
+			static bool isIndexValid(const uint64_t index) {
+				return index < capacity_count;
+			}
+		};
+
+		std::pmr::memory_resource* upstream = nullptr;	//backs both pools, nullptr means slab::_malloc
+		slab::ObjectPool<SkipListNode> nodePool{ 4, upstream };
+		slab::SlabAllocator<> towerPool{ static_cast<uint32_t>(SkipListNode::overflow_size), 4, upstream };
+		bbsl::Xoroshiro64StarStar rng;
+
+		SkipListNode sentryHead{ 0, bbsl::max_level - 1, towerPool };	//always full height, nullptr on the right is the tail
+
+		mutable EpochDomain epochs;
+		std::mutex structure;		//guards the links, both pools, rng, width and the retired list
+		std::atomic<int64_t> level{ 0 };
+		uint64_t width = 0;
+		SkipListNode* retired = nullptr;
+		uint64_t retiredCount = 0;
+
+		value_t invalid;
+
+		/**
+		 * @brief the maximum node with baseIndex <= index, the caller is pinned or holds the mutex
+		 * @param index
+		 * @param path the predecessors, only when the caller holds the mutex
+		 * @return sentryHead if there is no such node
+		 */
+		SkipListNode* findFloorNode(const index_t index, SkipListNode** path = nullptr) const {
+			SkipListNode* node = const_cast<SkipListNode*>(&this->sentryHead);
+			int64_t curLevel = (path != nullptr) ? (bbsl::max_level - 1) : this->level.load(std::memory_order_acquire);
+
+			while (curLevel >= 0) {
+				SkipListNode* next = node->getRightNode(static_cast<uint8_t>(curLevel));
+				if (next != nullptr && next->baseIndex <= index) {
+					node = next;
+					bbsl::prefetch(node->getRightNode(static_cast<uint8_t>(curLevel)));
+				}
+				else {
+					if (path != nullptr) path[curLevel] = node;
+					--curLevel;
+				}
+			}
+			return node;
+		}
+
+		/**
+		 * @brief the last node with baseIndex < index on every level, the caller holds the mutex
+		 * @param index
+		 * @param path
+		 * @return the node right after path[0]
+		 */
+		SkipListNode* findPredecessors(const index_t index, SkipListNode** path) {
+			SkipListNode* node = &this->sentryHead;
+			for (int64_t curLevel = bbsl::max_level - 1; curLevel >= 0; --curLevel) {
+				const uint8_t l = static_cast<uint8_t>(curLevel);
+				SkipListNode* next = node->getRightNode(l);
+				while (next != nullptr && next->baseIndex < index) {
+					node = next;
+					next = node->getRightNode(l);
+				}
+				path[l] = node;
+			}
+			return node->getRightNode(0);
+		}
+
+		bool covers(const SkipListNode* node, const index_t index) const {
+			return node != &this->sentryHead && SkipListNode::isIndexValid(index - node->baseIndex);
+		}
+
+		uint8_t getRandomLevel() {
+			// the list keeps width < 2 ^ (level + 1) nodes per level on average
+			uint8_t cap = 0;
+			while (cap < bbsl::max_level - 1 && (1ULL << cap) <= this->width) ++cap;
+			const uint8_t count = static_cast<uint8_t>(bits::ctz64(this->rng.next()) & 31);
+			return (count <= cap) ? count : cap;
+		}
+
+		/**
+		 * @brief set through the mutex, the block may be missing or about to be removed
+		 */
+		void setSlow(const index_t index, const value_t& value) {
+			std::lock_guard<std::mutex> lock(this->structure);
+			SkipListNode* path[bbsl::max_level];
+			SkipListNode* node = this->findFloorNode(index, path);
+
+			if (this->covers(node, index)) {
+				// nobody can remove the node while the mutex is held
+				const uint8_t offset = static_cast<uint8_t>(index - node->baseIndex);
+				node->elements[offset].store(value, std::memory_order_release);
+				node->bitMap.fetch_or(static_cast<bitMap_t>(bitMap_t(1) << offset), std::memory_order_seq_cst);
+				return;
+			}
+
+			const uint8_t nodeLevel = this->getRandomLevel();
+			SkipListNode* newNode = this->nodePool.allocate(index - (index & index_align), nodeLevel, this->towerPool);
+			const uint8_t offset = static_cast<uint8_t>(index - newNode->baseIndex);
+			newNode->elements[offset].store(value, std::memory_order_relaxed);
+			newNode->bitMap.store(static_cast<bitMap_t>(bitMap_t(1) << offset), std::memory_order_relaxed);
+
+			// link bottom up, a reader finds the node on level 0 first and every level above only shortens its walk
+			for (uint8_t i = 0; i <= nodeLevel; ++i) {
+				newNode->link(i).store(path[i]->getRightNode(i), std::memory_order_relaxed);
+				path[i]->setRightNode(i, newNode);
+			}
+
+			++this->width;
+			if (nodeLevel > this->level.load(std::memory_order_relaxed)) this->level.store(nodeLevel, std::memory_order_release);
+		}
+
+		/**
+		 * @brief unlink a block that looked empty, unless a writer filled it again meanwhile
+		 * @param node
+		 */
+		void tryRemove(SkipListNode* node) {
+			std::lock_guard<std::mutex> lock(this->structure);
+			// the node may have been removed by another eraser already, the caller is pinned so it is not freed yet
+			SkipListNode* path[bbsl::max_level];
+			if (this->findPredecessors(node->baseIndex, path) != node) return;
+
+			// pairs with the fast path of set: either it sees dead and retries, or we see its bit
+			node->dead.store(true, std::memory_order_seq_cst);
+			if (node->bitMap.load(std::memory_order_seq_cst) != 0) {
+				node->dead.store(false, std::memory_order_seq_cst);
+				return;
+			}
+
+			// top down, the node keeps its own links so readers standing on it can move on
+			for (int64_t i = node->level; i >= 0; --i) {
+				const uint8_t l = static_cast<uint8_t>(i);
+				path[l]->setRightNode(l, node->getRightNode(l));
+			}
+			--this->width;
+
+			node->retiredEpoch = this->epochs.retireEpoch();
+			node->retiredNext = this->retired;
+			this->retired = node;
+			++this->retiredCount;
+
+			constexpr uint64_t reclaimBatch = 64;
+			if (this->retiredCount >= reclaimBatch) this->reclaim();
+		}
+
+		/**
+		 * @brief free the retired nodes no reader can hold anymore, the caller holds the mutex
+		 */
+		void reclaim() {
+			const uint64_t safe = this->epochs.safeEpoch();
+			SkipListNode** link = &this->retired;
+
+			while (*link != nullptr) {
+				SkipListNode* node = *link;
+				if (node->retiredEpoch < safe) {
+					*link = node->retiredNext;
+					node->releaseTower(this->towerPool);
+					this->nodePool.deallocate(node);
+					--this->retiredCount;
+				}
+				else {
+					link = &node->retiredNext;
+				}
+			}
+		}
+
+	public:
+		/**
+		 * @brief
+		 * @param invalid invalid value, it should be a default value that is not used in the data
+		 */
+		ConcurrentBitmappedBlockSkipList(const value_t& invalid) : invalid(invalid) {}
+
+		ConcurrentBitmappedBlockSkipList(const value_t& invalid, uint64_t seed) : rng(seed), invalid(invalid) {}
+
+		/**
+		 * @param invalid
+		 * @param upstream memory for the slabs, it must outlive the list
+		 */
+		ConcurrentBitmappedBlockSkipList(const value_t& invalid, std::pmr::memory_resource* upstream) : upstream(upstream), invalid(invalid) {}
+
+		ConcurrentBitmappedBlockSkipList(const ConcurrentBitmappedBlockSkipList&) = delete;
+		ConcurrentBitmappedBlockSkipList& operator=(const ConcurrentBitmappedBlockSkipList&) = delete;
+
+		/**
+		 * @brief no thread may use the list anymore
+		 */
+		~ConcurrentBitmappedBlockSkipList() {
+			// the pools free every slab, retired nodes included
+			this->sentryHead.releaseTower(this->towerPool);
+		}
+
+		/**
+		 * @brief lock free
+		 * @param index
+		 * @param out only written when the element exists
+		 * @return
+		 */
+		bool get(const index_t index, value_t& out) const {
+			auto guard = this->epochs.pin();
+			const SkipListNode* node = this->findFloorNode(index);
+
+			if (this->covers(node, index)) {
+				const uint8_t offset = static_cast<uint8_t>(index - node->baseIndex);
+				bitMap_t mask = node->bitMap.load(std::memory_order_acquire);
+				if (bits::get(mask, offset)) {
+					out = node->elements[offset].load(std::memory_order_acquire);
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/**
+		 * @brief lock free
+		 * @param index
+		 * @return the value, or invalid
+		 */
+		value_t get(const index_t index) const {
+			value_t value = this->invalid;
+			this->get(index, value);
+			return value;
+		}
+
+		bool has(const index_t index) const {
+			auto guard = this->epochs.pin();
+			const SkipListNode* node = this->findFloorNode(index);
+			if (!this->covers(node, index)) return false;
+
+			bitMap_t mask = node->bitMap.load(std::memory_order_acquire);
+			return bits::get(mask, static_cast<uint8_t>(index - node->baseIndex));
+		}
+
+		/**
+		 * @brief lock free when the block exists, takes the structure mutex to create it otherwise
+		 * @param index
+		 * @param value
+		 */
+		void set(const index_t index, const value_t& value) {
+			{
+				auto guard = this->epochs.pin();
+				SkipListNode* node = this->findFloorNode(index);
+
+				if (this->covers(node, index) && !node->dead.load(std::memory_order_seq_cst)) {
+					const uint8_t offset = static_cast<uint8_t>(index - node->baseIndex);
+					node->elements[offset].store(value, std::memory_order_release);
+					node->bitMap.fetch_or(static_cast<bitMap_t>(bitMap_t(1) << offset), std::memory_order_seq_cst);
+
+					// a remover that missed our bit has marked the node before checking, so we see it here
+					if (!node->dead.load(std::memory_order_seq_cst)) return;
+				}
+			}
+			this->setSlow(index, value);
+		}
+
+		/**
+		 * @brief lock free unless the block becomes empty
+		 * @param index
+		 * @return true if the element existed
+		 */
+		bool erase(const index_t index) {
+			// stay pinned while removing, so the node cannot be freed before tryRemove looks at it
+			auto guard = this->epochs.pin();
+			SkipListNode* node = this->findFloorNode(index);
+			if (!this->covers(node, index)) return false;
+
+			const bitMap_t bit = static_cast<bitMap_t>(bitMap_t(1) << (index - node->baseIndex));
+			const bitMap_t old = node->bitMap.fetch_and(static_cast<bitMap_t>(~bit), std::memory_order_seq_cst);
+			if ((old & bit) == 0) return false;
+
+			if ((old & ~bit) == 0) this->tryRemove(node);
+			return true;
+		}
+
+		/**
+		 * @brief lock free walk in index order, each block is visited with a snapshot of its bitmap
+		 * @param func (value, index)
+		 */
+		template<typename Func>
+		void forEach(Func func) const {
+			auto guard = this->epochs.pin();
+			const SkipListNode* node = this->sentryHead.getRightNode(0);
+
+			while (node != nullptr) {
+				bitMap_t mask = node->bitMap.load(std::memory_order_acquire);
+				while (mask != 0) {
+					const uint8_t i = bits::ctz(mask);
+					func(node->elements[i].load(std::memory_order_acquire), node->baseIndex + i);
+					bits::set_zero(mask, i);
+				}
+				node = node->getRightNode(0);
+			}
+		}
+
+		/**
+		 * @brief O(blocks), exact only while no writer runs
+		 * @return
+		 */
+		uint64_t size() const {
+			uint64_t count = 0;
+			auto guard = this->epochs.pin();
+			const SkipListNode* node = this->sentryHead.getRightNode(0);
+			while (node != nullptr) {
+				count += bits::popcnt(node->bitMap.load(std::memory_order_relaxed));
+				node = node->getRightNode(0);
+			}
+			return count;
+		}
+
+		int64_t getLevel() const {
+			return this->level.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief free what the readers have released, writers already do this every few removals
+		 */
+		void collect() {
+			std::lock_guard<std::mutex> lock(this->structure);
+			this->reclaim();
+		}
+	};
+}
@@ -0,0 +1,304 @@
+/*
+ * MIT License
+ * Copyright (c) 2026 IMSDcrueoft (https://github.com/IMSDcrueoft)
+ * See LICENSE file in the root directory for full license text.
+*/
+#pragma once
+#include <algorithm>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "./bbsl.hpp"
+
+namespace bbsl {
+	/**
+	 * @brief read-only view of a file written by BitmappedBlockSkipList::serialize, the file is mapped and never copied
+	 * a lookup binary searches the directory of bases and reads one record, nothing is allocated per block,
+	 * so opening costs a few system calls and the pages come in as they are touched
+	 */
+	template <typename index_t, typename value_t, typename bitMap_t = uint16_t>
+	class MappedBitmappedBlockSkipList {
+		static_assert(std::is_integral_v<index_t> && std::is_trivial_v<value_t> && std::is_standard_layout_v<value_t>, "the records hold raw values");
+		static_assert(alignof(value_t) <= 8, "records are aligned to 8 bytes");
+
+	public:
+		static constexpr uint64_t capacity_count = sizeof(bitMap_t) * 8;
+
+	protected:
+		using wide_t = format::wide_index_t<index_t>;
+
+		const char* data = nullptr;
+		uint64_t length = 0;
+		const format::FileHeader* header = nullptr;
+		const uint64_t* bases = nullptr;		// blockCount sorted bases
+		const uint64_t* offsets = nullptr;		// blockCount record offsets
+		uint64_t blockCount = 0;
+#if defined(_WIN32)
+		HANDLE file = INVALID_HANDLE_VALUE;
+		HANDLE mapping = nullptr;
+#endif
+
+		value_t invalid;//you need an invalid default value
+
+		const format::BlockHeader* record(const uint64_t block) const {
+			return reinterpret_cast<const format::BlockHeader*>(this->data + this->offsets[block]);
+		}
+
+		static const value_t* packed(const format::BlockHeader* record) {
+			return reinterpret_cast<const value_t*>(record + 1);
+		}
+
+		static const format::BlockHeader* nextRecord(const format::BlockHeader* record) {
+			const uint64_t bytes = format::recordBytes(bits::popcnt(static_cast<bitMap_t>(record->bitMap)), sizeof(value_t));
+			return reinterpret_cast<const format::BlockHeader*>(reinterpret_cast<const char*>(record) + bytes);
+		}
+
+		/**
+		 * @brief
+		 * @param index
+		 * @return the last block with base <= index, blockCount if there is none
+		 */
+		uint64_t floorBlock(const index_t index) const {
+			const wide_t key = static_cast<wide_t>(index);
+			const uint64_t* end = this->bases + this->blockCount;
+			const uint64_t* upper = std::upper_bound(this->bases, end, key, [](const wide_t key, const uint64_t base) {
+				return key < static_cast<wide_t>(base);
+				});
+			return (upper == this->bases) ? this->blockCount : static_cast<uint64_t>(upper - this->bases) - 1;
+		}
+
+		/**
+		 * @brief
+		 * @param index
+		 * @return the element of index, nullptr if it is absent
+		 */
+		const value_t* find(const index_t index) const {
+			const uint64_t block = this->floorBlock(index);
+			if (block == this->blockCount) return nullptr;
+
+			const format::BlockHeader* rec = this->record(block);
+			// base <= index, the distance is taken unsigned so a far index cannot overflow
+			const uint64_t offset = static_cast<uint64_t>(index) - static_cast<uint64_t>(format::decodeIndex<index_t>(rec->baseIndex));
+			if (offset >= capacity_count) return nullptr;
+
+			const bitMap_t bitMap = static_cast<bitMap_t>(rec->bitMap);
+			const uint8_t bit = static_cast<uint8_t>(offset);
+			if (((bitMap >> bit) & 1) == 0) return nullptr;
+			// packed in index order, the rank of the bit is the slot
+			return packed(rec) + bits::popcnt(static_cast<bitMap_t>(bitMap & bits::mask_below<bitMap_t>(bit)));
+		}
+
+		bool mapFile(const char* path) {
+#if defined(_WIN32)
+			this->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (this->file == INVALID_HANDLE_VALUE) return false;
+
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(this->file, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(format::FileHeader))) return false;
+			this->mapping = CreateFileMappingA(this->file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (this->mapping == nullptr) return false;
+
+			this->data = static_cast<const char*>(MapViewOfFile(this->mapping, FILE_MAP_READ, 0, 0, 0));
+			this->length = static_cast<uint64_t>(size.QuadPart);
+			return this->data != nullptr;
+#else
+			const int fd = ::open(path, O_RDONLY);
+			if (fd < 0) return false;
+
+			struct stat info;
+			if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(format::FileHeader))) {
+				::close(fd);
+				return false;
+			}
+
+			// the mapping keeps the file alive, the descriptor is not needed anymore
+			void* memory = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+			::close(fd);
+			if (memory == MAP_FAILED) return false;
+
+			this->data = static_cast<const char*>(memory);
+			this->length = static_cast<uint64_t>(info.st_size);
+			return true;
+#endif
+		}
+
+	public:
+		MappedBitmappedBlockSkipList(const MappedBitmappedBlockSkipList&) = delete;
+		MappedBitmappedBlockSkipList& operator=(const MappedBitmappedBlockSkipList&) = delete;
+
+		MappedBitmappedBlockSkipList(MappedBitmappedBlockSkipList&&) = delete;
+		MappedBitmappedBlockSkipList& operator=(MappedBitmappedBlockSkipList&&) = delete;
+
+		MappedBitmappedBlockSkipList(const value_t& invalid) : invalid(invalid) {}
+
+		MappedBitmappedBlockSkipList(const value_t& invalid, const char* path) : invalid(invalid) {
+			this->open(path);
+		}
+
+		~MappedBitmappedBlockSkipList() {
+			this->close();
+		}
+
+		/**
+		 * @brief map a file, the header and the bounds of the directory are checked, the records are trusted (see verify)
+		 * @param path
+		 * @return false if the file cannot be mapped or was not written by a list of the same template arguments
+		 */
+		bool open(const char* path) {
+			this->close();
+			if (!this->mapFile(path)) {
+				this->close();
+				return false;
+			}
+
+			const format::FileHeader* head = reinterpret_cast<const format::FileHeader*>(this->data);
+			if (!format::compatible<index_t, value_t, bitMap_t>(*head) || head->fileBytes > this->length) {
+				this->close();
+				return false;
+			}
+
+			this->header = head;
+			this->blockCount = head->blockCount;
+			this->bases = reinterpret_cast<const uint64_t*>(this->data + head->directoryOffset);
+			this->offsets = this->bases + head->blockCount;
+			return true;
+		}
+
+		void close() {
+#if defined(_WIN32)
+			if (this->data != nullptr) UnmapViewOfFile(this->data);
+			if (this->mapping != nullptr) CloseHandle(this->mapping);
+			if (this->file != INVALID_HANDLE_VALUE) CloseHandle(this->file);
+			this->mapping = nullptr;
+			this->file = INVALID_HANDLE_VALUE;
+#else
+			if (this->data != nullptr) munmap(const_cast<char*>(this->data), static_cast<size_t>(this->length));
+#endif
+			this->data = nullptr;
+			this->length = 0;
+			this->header = nullptr;
+			this->bases = nullptr;
+			this->offsets = nullptr;
+			this->blockCount = 0;
+		}
+
+		/**
+		 * @brief O(blocks), walk every record and check it against the directory and the header
+		 * @return false if the file is damaged, the view should not be used then
+		 */
+		bool verify() const {
+			if (this->header == nullptr) return false;
+
+			const format::BlockHeader* rec = reinterpret_cast<const format::BlockHeader*>(this->data + sizeof(format::FileHeader));
+			const char* limit = this->data + this->header->directoryOffset;
+			uint64_t elements = 0;
+
+			for (uint64_t b = 0; b < this->blockCount; ++b) {
+				const char* position = reinterpret_cast<const char*>(rec);
+				if (position + sizeof(format::BlockHeader) > limit || this->offsets[b] != static_cast<uint64_t>(position - this->data)) return false;
+
+				const bitMap_t bitMap = static_cast<bitMap_t>(rec->bitMap);
+				if (bitMap == 0 || rec->bitMap != static_cast<uint64_t>(bitMap) || rec->baseIndex != this->bases[b]) return false;
+				if (b != 0 && !(static_cast<wide_t>(this->bases[b - 1]) < static_cast<wide_t>(this->bases[b]))) return false;
+
+				elements += bits::popcnt(bitMap);
+				rec = nextRecord(rec);
+			}
+			return reinterpret_cast<const char*>(rec) == limit && elements == this->header->elementCount;
+		}
+
+		bool isOpen() const {
+			return this->header != nullptr;
+		}
+
+		/**
+		 * @brief O(1)
+		 * @return the number of elements
+		 */
+		uint64_t size() const {
+			return (this->header != nullptr) ? this->header->elementCount : 0;
+		}
+
+		uint64_t blocks() const {
+			return this->blockCount;
+		}
+
+		bool has(const index_t index) const {
+			return this->find(index) != nullptr;
+		}
+
+		/**
+		 * @brief O(log blocks), one binary search over the bases and one record
+		 * @param index
+		 * @return the element, or the invalid value
+		 */
+		const value_t& operator[](const index_t index) const {
+			const value_t* value = this->find(index);
+			return (value != nullptr) ? *value : this->invalid;
+		}
+
+		/**
+		 * @brief the records are contiguous, so this is one sequential pass over the mapped file
+		 * @param func (value, index)
+		 */
+		template<typename Func>
+		void forEach(Func func) const {
+			if (this->blockCount == 0) return;
+
+			const format::BlockHeader* rec = this->record(0);
+			for (uint64_t b = 0; b < this->blockCount; ++b) {
+				const index_t base = format::decodeIndex<index_t>(rec->baseIndex);
+				const value_t* values = packed(rec);
+
+				bitMap_t mask = static_cast<bitMap_t>(rec->bitMap);
+				while (mask != 0) {
+					const uint8_t i = bits::ctz(mask);
+					func(*values++, base + i);
+					bits::set_zero(mask, i);
+				}
+				rec = nextRecord(rec);
+			}
+		}
+
+		/**
+		 * @brief visit [start, end) in index order after one binary search
+		 * @param start
+		 * @param end
+		 * @param func (value, index)
+		 */
+		template<typename Func>
+		void forEachInRange(const index_t start, const index_t end, Func func) const {
+			if (this->blockCount == 0 || !(start < end)) return;
+
+			uint64_t b = this->floorBlock(start);
+			if (b == this->blockCount) b = 0;
+
+			for (; b < this->blockCount; ++b) {
+				const format::BlockHeader* rec = this->record(b);
+				const index_t base = format::decodeIndex<index_t>(rec->baseIndex);
+				if (!(base < end)) break;
+
+				const value_t* values = packed(rec);
+				bitMap_t mask = static_cast<bitMap_t>(rec->bitMap);
+				while (mask != 0) {
+					const uint8_t i = bits::ctz(mask);
+					const index_t index = base + i;
+					if (!(index < end)) return;
+					if (!(index < start)) func(*values, index);
+					++values;
+					bits::set_zero(mask, i);
+				}
+			}
+		}
+	};
+}
@@ -10,6 +10,9 @@
 #include <iostream>
 #include <cassert>
 #include <algorithm>
+#include <mutex>
+#include <memory_resource>
+#include <type_traits>
 
 #include "./bits.hpp"
 
@@ -23,13 +26,43 @@ namespace slab {
 
 	// limit size
 	constexpr auto unit_max_size = 4096;
+	constexpr uint32_t slab_max_units = 64 * 64;	// one summary word over 64 bitmap words
+	constexpr size_t page_size = 4096;
+
+	/**
+	 * @brief how many units a slab holds, both are rounded up to whole multiples of 64 and limited to slab_max_units
+	 * the default keeps every slab at 64 units
+	 */
+	struct SlabGeometry {
+		uint32_t first_units = 64;		// units of the first slab
+		uint32_t max_units = 64;		// every new slab doubles the previous one up to this
+	};
+	/**
+	 * @brief a snapshot of a SlabAllocator, the counters stay 0 unless the allocator is counting
+	 */
+	struct SlabStats {
+		uint32_t total = 0;				// slabs held
+		uint32_t reserved = 0;			// empty slabs kept for reuse
+		uint32_t full = 0;				// slabs without a free unit
+		size_t bytes = 0;				// memory held from upstream
+		uint64_t allocations = 0;
+		uint64_t frees = 0;
+		uint64_t slabCreates = 0;		// slabs taken from upstream
+		uint64_t slabDestroys = 0;		// slabs given back to upstream
+		size_t peakBytes = 0;			// highest bytes ever held
+	};
+
 	static void* (*_malloc)(size_t size) = std::malloc;
 	static void (*_free)(void*) = std::free;
 
+	/**
+	 * @tparam counting count allocations, frees and slab traffic into stats(), the counting code is compiled out otherwise
+	 */
+	template<bool counting = false>
 	class SlabAllocator {
 	protected:
 		struct alignas(8) SlabUnit {
-			uint32_t index;				// only need 0-63
+			uint32_t index;				// 0 to units - 1 of the slab
 			uint32_t offset;			// the offset to SlabBlock
 			char payload[];
 
@@ -50,75 +83,89 @@ namespace slab {
 			SlabAllocator* allocator;	// pointer to the allocator
 			SlabBlock* next;			// next slab in the list
 			SlabBlock* prev;			// prev slab in the list
-			uint64_t bitMap;			// bit==1 means free (bitMap != 0)
-			char payload[];				// the slices
+			uint64_t summary;			// bit w == 1 means bitMap[w] has a free unit, so a slab holds at most 64 * 64 units
+			uint32_t units;				// a multiple of 64
+			uint32_t freeCount;
+			uint64_t bitMap[];			// bit==1 means free, one word per 64 units, the slices follow
 
 			SlabBlock() = delete;
 			~SlabBlock() = delete;
 
-			static void construct(SlabBlock* _this, const SlabAllocator* allocator) {
-				// Calculate the offset of the 'payload' flexible array member in SlabBlock.
-				// Allocate memory for the fixed part of the structure plus space for 64 units of metadata.
-				// This ensures the flexible array can be used safely without additional allocations.
-				constexpr size_t baseOffset = OFFSET_OF(SlabBlock, payload);
+			static size_t bytesFor(const uint32_t units, const uint32_t unitMetaSize) {
+				return OFFSET_OF(SlabBlock, bitMap) + sizeof(uint64_t) * (units >> 6) + static_cast<size_t>(units) * unitMetaSize;
+			}
+
+			static void construct(SlabBlock* _this, const SlabAllocator* allocator, const uint32_t units) {
+				// the words and the units live in the same allocation right after the fixed part
+				const uint32_t words = units >> 6;
+				const size_t baseOffset = OFFSET_OF(SlabBlock, bitMap) + sizeof(uint64_t) * words;
 
 				_this->allocator = const_cast<SlabAllocator*>(allocator); // set allocator pointer
 				_this->prev = nullptr;
 				_this->next = nullptr;
-				_this->bitMap = UINT64_MAX; // all free
+				_this->units = units;
+				_this->freeCount = units;
+				_this->summary = (words == 64) ? UINT64_MAX : ((1ULL << words) - 1);
+				std::fill_n(_this->bitMap, words, UINT64_MAX); // all free
 
-				for (size_t i = 0; i < 64; ++i) {
-					const auto currentOffset = baseOffset + i * allocator->unitMetaSize;
+				for (uint32_t i = 0; i < units; ++i) {
+					const auto currentOffset = baseOffset + static_cast<size_t>(i) * allocator->unitMetaSize;
 					SlabUnit* unit = (SlabUnit*)(reinterpret_cast<char*>(_this) + currentOffset);
-					SlabUnit::construct(unit, i, currentOffset);
+					SlabUnit::construct(unit, i, static_cast<uint32_t>(currentOffset));
 				}
 			}
 
 			static void destroy(SlabBlock* _this) {
-				_free(_this);
+				_this->allocator->releaseMemory(_this);
 			}
 
 			bool isFull() const {
-				return this->bitMap == 0;
+				return this->freeCount == 0;
 			}
 
 			bool isEmpty() const {
-				return this->bitMap == UINT64_MAX;
+				return this->freeCount == this->units;
 			}
 
 			bool isUnitAllocated(const uint32_t index) const {
 				// if bit is 0, it means the unit is allocated
-				return bits::get(this->bitMap, index) == 0;
+				return bits::get(this->bitMap[index >> 6], static_cast<uint8_t>(index & 63)) == 0;
+			}
+
+			char* payload() const {
+				return (char*)(this->bitMap + (this->units >> 6));
 			}
 
 			SlabUnit* getUnitByIndex(const size_t unitMetaSize, const uint32_t index) const {
-				assert(index < 64 && "Index out of bounds in getUnitByIndex");
+				assert(index < this->units && "Index out of bounds in getUnitByIndex");
 
-				return (SlabUnit*)((char*)this->payload + index * unitMetaSize);
+				return (SlabUnit*)(this->payload() + index * unitMetaSize);
 			}
 
 			SlabUnit* allocateUnit(const size_t unitMetaSize) {
 				assert(!this->isFull() && "SlabBlock is full, cannot allocate unit.");
 
-				uint32_t index = bits::ctz64(this->bitMap);
-				bits::set_zero(this->bitMap, index);
-				return (SlabUnit*)((char*)this->payload + index * unitMetaSize);
+				const uint32_t word = bits::ctz64(this->summary);
+				const uint32_t index = bits::ctz64(this->bitMap[word]);
+				bits::set_zero(this->bitMap[word], index);
+				if (this->bitMap[word] == 0) bits::set_zero(this->summary, word);
+				--this->freeCount;
+				return (SlabUnit*)(this->payload() + ((word << 6) + index) * unitMetaSize);
 			}
 
 			void deallocateUnit(const uint32_t index) {
-				bits::set_one(this->bitMap, index);
+				bits::set_one(this->bitMap[index >> 6], static_cast<uint8_t>(index & 63));
+				bits::set_one(this->summary, static_cast<uint8_t>(index >> 6));
+				++this->freeCount;
 			}
 
-			static SlabBlock* create(const SlabAllocator* allocator) {
-				// Calculate the offset of the 'payload' flexible array member in SlabBlock.
-				// Allocate memory for the fixed part of the structure plus space for 64 units of metadata.
+			static SlabBlock* create(SlabAllocator* allocator, const uint32_t units) {
+				// Allocate memory for the fixed part of the structure plus space for the words and units.
 				// This ensures the flexible array can be used safely without additional allocations.
-				constexpr size_t baseOffset = OFFSET_OF(SlabBlock, payload);
-
-				SlabBlock* slab = (SlabBlock*)_malloc(baseOffset + (static_cast<size_t>(64) * allocator->unitMetaSize));
+				SlabBlock* slab = (SlabBlock*)allocator->acquireMemory(bytesFor(units, allocator->unitMetaSize));
 
 				if (slab != nullptr) {
-					SlabBlock::construct(slab, allocator);
+					SlabBlock::construct(slab, allocator, units);
 					return slab;
 				}
 
@@ -152,18 +199,61 @@ namespace slab {
 		uint32_t total_count = 0;		// total slab count
 		uint32_t reserved_count;		// reserved free slab count
 		uint32_t reserved_limit;		// reserved free slab limit
+		std::pmr::memory_resource* upstream = nullptr;	// where the slabs come from, nullptr means _malloc / _free
+		SlabGeometry geometry;
+		uint32_t next_units = 64;		// size of the next new slab
+		size_t total_bytes = 0;			// memory held from upstream
+		SlabStats counters;				// only the counter fields are used, and only when counting
 
 	protected:
+		static size_t alignmentFor(const size_t bytes) {
+			// slabs of a page or more start on a page, so one slab never shares a page or a TLB entry with another
+			return (bytes >= slab::page_size) ? slab::page_size : alignof(std::max_align_t);
+		}
+
+		void* acquireMemory(const size_t bytes) {
+			void* memory = nullptr;
+			if (this->upstream == nullptr) memory = _malloc(bytes);
+			else {
+				// a resource reports failure by throwing, keep the nullptr contract of _malloc
+				try {
+					memory = this->upstream->allocate(bytes, alignmentFor(bytes));
+				}
+				catch (const std::bad_alloc&) {
+					memory = nullptr;
+				}
+			}
+			if (memory != nullptr) {
+				this->total_bytes += bytes;
+				if constexpr (counting) {
+					++this->counters.slabCreates;
+					this->counters.peakBytes = std::max(this->counters.peakBytes, this->total_bytes);
+				}
+			}
+			return memory;
+		}
+
+		void releaseMemory(SlabBlock* slab) {
+			const size_t bytes = SlabBlock::bytesFor(slab->units, this->unitMetaSize);
+			this->total_bytes -= bytes;
+			if constexpr (counting) ++this->counters.slabDestroys;
+			if (this->upstream == nullptr) _free(slab);
+			else this->upstream->deallocate(slab, bytes, alignmentFor(bytes));
+		}
+
 		/**
 		 * @brief create a block for work
 		 */
-		SlabBlock* makeBlock() const {
-			SlabBlock* slab = SlabBlock::create(this);
+		SlabBlock* makeBlock() {
+			SlabBlock* slab = SlabBlock::create(this, this->next_units);
 			if (slab == nullptr) {
 				std::cerr << "slabAllocator: failed in allocating memory." << std::endl;
 				exit(1);
 			}
 
+			// growth policy: every new slab doubles the previous one up to max_units, bursts reach malloc less and less
+			this->next_units = std::min(this->next_units << 1, this->geometry.max_units);
+
 			slab->next = slab; // link as a circle
 			slab->prev = slab; // link as a circle
 			return slab;
@@ -271,12 +361,25 @@ namespace slab {
 		SlabAllocator(SlabAllocator&&) = delete;
 		SlabAllocator& operator=(SlabAllocator&&) = delete;
 
-		SlabAllocator(uint32_t unitSize, const uint32_t reserved_limit = 4) {
+		/**
+		 * @param unitSize
+		 * @param reserved_limit free slabs kept for reuse
+		 * @param upstream a memory resource for the slabs (an arena, huge pages, NUMA local memory), it must outlive the allocator
+		 * @param geometry units of the first slab and the growth limit
+		 */
+		SlabAllocator(uint32_t unitSize, const uint32_t reserved_limit = 4, std::pmr::memory_resource* upstream = nullptr, const SlabGeometry geometry = SlabGeometry())
+			: upstream(upstream), geometry(geometry) {
 			if (unitSize > slab::unit_max_size) {
 				std::cerr << "Invalid unitSize for SlabAllocator" << std::endl;
 				exit(1);
 			}
 
+			// whole words of 64 units, at most one summary word of them
+			auto clampUnits = [](const uint32_t units) { return std::min(std::max((units + 63) & ~63u, 64u), slab::slab_max_units); };
+			this->geometry.first_units = clampUnits(this->geometry.first_units);
+			this->geometry.max_units = std::max(clampUnits(this->geometry.max_units), this->geometry.first_units);
+			this->next_units = this->geometry.first_units;
+
 			unitSize = (unitSize + 7) & ~7;// align to 8
 			this->unitMetaSize = (sizeof(SlabUnit) + unitSize);
 
@@ -313,7 +416,15 @@ namespace slab {
 			return this->unitMetaSize - sizeof(SlabUnit);
 		}
 
+		/**
+		 * @brief memory held from upstream, including reserved free slabs
+		 */
+		size_t bytes() const {
+			return this->total_bytes;
+		}
+
 		void* allocate() {
+			if constexpr (counting) ++this->counters.allocations;
 			SlabBlock* slab = this->work;
 
 			if (slab == nullptr) {
@@ -350,11 +461,6 @@ namespace slab {
 			//getSlabUnitFromPtr
 			SlabUnit* unit = SlabUnit::getUnitFromPayload(ptr);
 
-			if (unit->index >= 64) {
-				std::cerr << "deallocate: Invalid unit index " << unit->index << std::endl;
-				return;
-			}
-
 			//getBlockFromUnit
 			SlabBlock* slab = SlabBlock::getBlockFromUnit(unit);
 
@@ -363,7 +469,13 @@ namespace slab {
 				return; // invalid slab
 			}
 
+			if (unit->index >= slab->units) {
+				std::cerr << "deallocate: Invalid unit index " << unit->index << std::endl;
+				return;
+			}
+
 			if (slab->isUnitAllocated(unit->index)) {
+				if constexpr (counting) ++this->counters.frees;
 				bool isFull = slab->isFull();
 				slab->deallocateUnit(unit->index);
 
@@ -385,6 +497,85 @@ namespace slab {
 			}
 		}
 
+		/**
+		 * @brief give every unit back in one go, keep up to reserved_limit slabs for reuse and free the rest
+		 * all pointers handed out before are invalid afterwards
+		 */
+		void reset() {
+			SlabBlock* kept = nullptr;
+			uint32_t keptCount = 0;
+
+			SlabBlock* lists[2] = { this->full, this->work };
+			for (SlabBlock* begin : lists) {
+				if (begin == nullptr) continue;
+
+				SlabBlock* slab = begin;
+				do {
+					SlabBlock* next = slab->next;
+					if (keptCount < this->reserved_limit) {
+						SlabBlock::construct(slab, this, slab->units);
+						slab->next = kept;
+						kept = slab;
+						++keptCount;
+					}
+					else {
+						SlabBlock::destroy(slab);
+					}
+					slab = next;
+				} while (slab != begin);
+			}
+
+			this->full = nullptr;
+			this->work = nullptr;
+
+			//link the kept slabs as a circle
+			while (kept != nullptr) {
+				SlabBlock* next = kept->next;
+				if (this->work == nullptr) {
+					kept->next = kept;
+					kept->prev = kept;
+				}
+				else {
+					kept->next = this->work;
+					kept->prev = this->work->prev;
+					kept->next->prev = kept;
+					kept->prev->next = kept;
+				}
+				this->work = kept;
+				kept = next;
+			}
+
+			this->total_count = keptCount;
+			this->reserved_count = keptCount;
+		}
+
+		/**
+		 * @brief O(full slabs), a structured view of the allocator
+		 */
+		SlabStats stats() const {
+			SlabStats result = this->counters;
+			result.total = this->total_count;
+			result.reserved = this->reserved_count;
+			result.bytes = this->total_bytes;
+
+			if (this->full != nullptr) {
+				const SlabBlock* slab = this->full;
+				do {
+					++result.full;
+					slab = slab->next;
+				} while (slab != this->full);
+			}
+			return result;
+		}
+
+		/**
+		 * @brief zero the counters, peakBytes restarts from the bytes held now
+		 */
+		void resetCounters() {
+			this->counters = SlabStats();
+			this->counters.peakBytes = this->total_bytes;
+		}
+
 		void print_stats() {
 			std::cout << "print_stats:" << std::endl;
 
@@ -405,8 +596,8 @@ namespace slab {
 				SlabBlock* slab = this->work;
 
 				do {
-					std::cout << "slab_" << id << " " << 64 - bits::popcnt64(slab->bitMap) << " / 64" << std::endl;
-					SlabBlock::print_bitMap(slab->bitMap);
+					std::cout << "slab_" << id << " " << slab->units - slab->freeCount << " / " << slab->units << std::endl;
+					for (uint32_t word = 0; word < (slab->units >> 6); ++word) SlabBlock::print_bitMap(slab->bitMap[word]);
 					std::cout << std::endl;
 					slab = slab->next;
 
@@ -418,26 +609,39 @@ namespace slab {
 		}
 	};
 
-	template<typename T>
-	class ObjectPool : protected SlabAllocator {
+	template<typename T, bool counting = false>
+	class ObjectPool : protected SlabAllocator<counting> {
 	protected:
-		void destroyList(SlabBlock* begin) {
+		using Base = SlabAllocator<counting>;
+		using typename Base::SlabBlock;
+		using typename Base::SlabUnit;
+
+		void destructList(SlabBlock* begin) {
+			// nothing to run, the slabs can be dropped without looking at a single unit
+			if constexpr (std::is_trivially_destructible_v<T>) return;
+
+			if (begin == nullptr) return;
 			SlabBlock* slab = begin;
 
 			do {
-				SlabBlock* next = slab->next;
-
-				for (uint32_t i = 0; i < 64; ++i) {
-					if (slab->isUnitAllocated(i)) {
+				// only the allocated units, a whole free word is skipped at once
+				for (uint32_t word = 0; word < (slab->units >> 6); ++word) {
+					uint64_t allocated = ~slab->bitMap[word];
+					while (allocated != 0) {
+						const uint32_t i = (word << 6) + bits::ctz64(allocated);
 						SlabUnit* unit = slab->getUnitByIndex(this->unitMetaSize, i);
 						reinterpret_cast<T*>(unit->payload)->~T(); // call destructor for T
+						allocated &= allocated - 1;
 					}
 				}
-
-				SlabBlock::destroy(slab);
-				slab = next;
+				slab = slab->next;
 			} while (slab != begin);
 		}
+
+		void destroyList(SlabBlock* begin) {
+			this->destructList(begin);
+			Base::destroyList(begin);
+		}
 	public:
 		ObjectPool(const ObjectPool&) = delete;
 		ObjectPool& operator=(const ObjectPool&) = delete;
@@ -445,7 +649,16 @@ namespace slab {
 		ObjectPool(ObjectPool&&) = delete;
 		ObjectPool& operator=(ObjectPool&&) = delete;
 
-		ObjectPool(uint32_t reserved_limit = 4) : SlabAllocator(sizeof(T), reserved_limit) {}
+		using Base::total;
+		using Base::reserved;
+		using Base::unitSize;
+		using Base::bytes;
+		using Base::stats;
+		using Base::resetCounters;
+
+		ObjectPool(uint32_t reserved_limit = 4, std::pmr::memory_resource* upstream = nullptr, const SlabGeometry geometry = SlabGeometry())
+			: Base(sizeof(T), reserved_limit, upstream, geometry) {
+		}
 		~ObjectPool() {
 			if (this->full != nullptr) {
 				destroyList(this->full);
@@ -459,23 +672,245 @@ namespace slab {
 
 		template<typename... Args>
 		T* allocate(Args&&... args) {
-			return new (SlabAllocator::allocate()) T(std::forward<Args>(args)...);// allocate memory for T using SlabAllocator
+			return new (Base::allocate()) T(std::forward<Args>(args)...);// allocate memory for T using SlabAllocator
 		}
 
 		void deallocate(T* ptr) {
-			ptr->~T(); // call destructor
-			SlabAllocator::deallocate(ptr);
+			if constexpr (!std::is_trivially_destructible_v<T>) ptr->~T(); // call destructor
+			Base::deallocate(ptr);
+		}
+
+		/**
+		 * @brief destroy every live object and give all units back in one go
+		 */
+		void reset() {
+			this->destructList(this->full);
+			this->destructList(this->work);
+			Base::reset();
 		}
 
 		// for advanced users who want to manage construction and destruction themselves
 		T* allocate_no_construct() {
-			return reinterpret_cast<T*>(SlabAllocator::allocate());
+			return reinterpret_cast<T*>(Base::allocate());
 		}
 
 		// for advanced users who want to manage construction and destruction themselves
 		void deallocate_no_destruct(T* ptr) {
-			SlabAllocator::deallocate(ptr);
+			Base::deallocate(ptr);
+		}
+	};
+
+	/**
+	 * @brief thread safe front-end of a SlabAllocator, shared by every thread that owns a Cache of it
+	 * each Cache keeps two magazines of free units, so a thread only takes the lock once per magazine_size calls,
+	 * full magazines are exchanged through a depot and the slabs behind it are only touched in batches
+	 * a unit may be freed by any thread, it simply lands in the magazine of that thread
+	 */
+	template<bool counting = false>
+	class SharedSlabAllocator {
+	public:
+		static constexpr uint32_t magazine_size = 32;
+
+	protected:
+		struct Magazine {
+			Magazine* next;
+			uint32_t count;
+			void* units[magazine_size];
+		};
+
+		SlabAllocator<counting> backend;
+		std::mutex lock;				// guards backend and depot
+		Magazine* depotFull = nullptr;	// magazines with magazine_size units
+		Magazine* depotEmpty = nullptr;	// spare magazines
+		uint32_t depot_count = 0;		// full magazines in the depot
+		uint32_t depot_limit;			// full magazines kept in the depot, the rest goes back to the slabs
+
+		static Magazine* makeMagazine() {
+			Magazine* magazine = static_cast<Magazine*>(_malloc(sizeof(Magazine)));
+			if (magazine == nullptr) {
+				std::cerr << "SharedSlabAllocator: failed in allocating memory." << std::endl;
+				exit(1);
+			}
+			magazine->next = nullptr;
+			magazine->count = 0;
+			return magazine;
+		}
+
+		static Magazine* pop(Magazine*& list) {
+			Magazine* magazine = list;
+			if (magazine != nullptr) list = magazine->next;
+			return magazine;
+		}
+
+		static void push(Magazine*& list, Magazine* magazine) {
+			magazine->next = list;
+			list = magazine;
+		}
+
+		/**
+		 * @brief swap an empty magazine for a full one, filled from the slabs when the depot has none
+		 * @param empty
+		 * @return
+		 */
+		Magazine* exchangeEmpty(Magazine* empty) {
+			std::lock_guard<std::mutex> guard(this->lock);
+			Magazine* full = pop(this->depotFull);
+			if (full != nullptr) {
+				--this->depot_count;
+				push(this->depotEmpty, empty);
+				return full;
+			}
+
+			while (empty->count < magazine_size) {
+				empty->units[empty->count++] = this->backend.allocate();
+			}
+			return empty;
 		}
+
+		/**
+		 * @brief swap a full magazine for an empty one, the units go back to the slabs when the depot is at its limit
+		 * @param full
+		 * @return
+		 */
+		Magazine* exchangeFull(Magazine* full) {
+			std::lock_guard<std::mutex> guard(this->lock);
+			if (this->depot_count < this->depot_limit) {
+				++this->depot_count;
+				push(this->depotFull, full);
+				Magazine* empty = pop(this->depotEmpty);
+				return (empty != nullptr) ? empty : makeMagazine();
+			}
+
+			while (full->count > 0) {
+				this->backend.deallocate(full->units[--full->count]);
+			}
+			return full;
+		}
+
+		void release(Magazine* magazine) {
+			std::lock_guard<std::mutex> guard(this->lock);
+			while (magazine->count > 0) {
+				this->backend.deallocate(magazine->units[--magazine->count]);
+			}
+			push(this->depotEmpty, magazine);
+		}
+
+		static void freeMagazines(Magazine* list) {
+			while (list != nullptr) {
+				Magazine* next = list->next;
+				_free(list);
+				list = next;
+			}
+		}
+
+	public:
+		/**
+		 * @brief per thread handle, create one in every thread that allocates or frees, it must not outlive the allocator
+		 */
+		class Cache {
+		private:
+			SharedSlabAllocator* shared;
+			Magazine* loaded;
+			Magazine* previous;
+
+		public:
+			Cache(SharedSlabAllocator& shared) : shared(&shared), loaded(makeMagazine()), previous(makeMagazine()) {}
+
+			Cache(const Cache&) = delete;
+			Cache& operator=(const Cache&) = delete;
+
+			~Cache() {
+				this->shared->release(this->loaded);
+				this->shared->release(this->previous);
+			}
+
+			void* allocate() {
+				if (this->loaded->count == 0) {
+					if (this->previous->count != 0) std::swap(this->loaded, this->previous);
+					else this->loaded = this->shared->exchangeEmpty(this->loaded);
+				}
+				return this->loaded->units[--this->loaded->count];
+			}
+
+			void deallocate(void* ptr) {
+				if (this->loaded->count == magazine_size) {
+					if (this->previous->count == 0) std::swap(this->loaded, this->previous);
+					else this->loaded = this->shared->exchangeFull(this->loaded);
+				}
+				this->loaded->units[this->loaded->count++] = ptr;
+			}
+		};
+
+		SharedSlabAllocator(const SharedSlabAllocator&) = delete;
+		SharedSlabAllocator& operator=(const SharedSlabAllocator&) = delete;
+
+		SharedSlabAllocator(const uint32_t unitSize, const uint32_t reserved_limit = 4, const uint32_t depot_limit = 16, std::pmr::memory_resource* upstream = nullptr)
+			: backend(unitSize, reserved_limit, upstream), depot_limit(depot_limit) {
+		}
+
+		/**
+		 * @brief every Cache must be gone
+		 */
+		~SharedSlabAllocator() {
+			freeMagazines(this->depotFull);
+			freeMagazines(this->depotEmpty);
+		}
+
+		// without a Cache, always under the lock
+		void* allocate() {
+			std::lock_guard<std::mutex> guard(this->lock);
+			return this->backend.allocate();
+		}
+
+		void deallocate(void* ptr) {
+			std::lock_guard<std::mutex> guard(this->lock);
+			this->backend.deallocate(ptr);
+		}
+
+		uint32_t unitSize() {
+			std::lock_guard<std::mutex> guard(this->lock);
+			return this->backend.unitSize();
+		}
+
+		/**
+		 * @brief slabs held by the backend, units parked in magazines count as allocated there
+		 */
+		uint32_t total() {
+			std::lock_guard<std::mutex> guard(this->lock);
+			return this->backend.total();
+		}
+
+		/**
+		 * @brief stats of the backend, a unit counts as allocated or freed when it crosses a magazine
+		 */
+		SlabStats stats() {
+			std::lock_guard<std::mutex> guard(this->lock);
+			return this->backend.stats();
+		}
+	};
+
+	/**
+	 * @brief typed SharedSlabAllocator, objects are constructed and destroyed through a per thread Cache
+	 */
+	template<typename T, bool counting = false>
+	class SharedObjectPool : public SharedSlabAllocator<counting> {
+	public:
+		class Cache : public SharedSlabAllocator<counting>::Cache {
+		public:
+			Cache(SharedObjectPool& pool) : SharedSlabAllocator<counting>::Cache(pool) {}
+
+			template<typename... Args>
+			T* create(Args&&... args) {
+				return new (this->allocate()) T(std::forward<Args>(args)...);
+			}
+
+			void destroy(T* ptr) {
+				ptr->~T();
+				this->deallocate(ptr);
+			}
+		};
+
+		SharedObjectPool(const uint32_t reserved_limit = 4, const uint32_t depot_limit = 16, std::pmr::memory_resource* upstream = nullptr) : SharedSlabAllocator<counting>(sizeof(T), reserved_limit, depot_limit, upstream) {}
 	};
 #undef OFFSET_OF
 }
\ No newline at end of file
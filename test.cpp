@@ -4,6 +4,8 @@
  * See LICENSE file in the root directory for full license text.
 */
 #include "./src/bbsl.hpp"
+#include "./src/cbbsl.hpp"
+#include "./src/mbbsl.hpp"
 #include <cmath>
 #include <iostream>
 #include <vector>
@@ -13,6 +15,15 @@
 #include <random>
 #include <algorithm>
 #include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <memory_resource>
+#include <numeric>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <stdexcept>
 
 constexpr auto testCount = 1'000'000;
 using namespace bbsl;
@@ -137,6 +148,2108 @@ void test4() {
     std::cout << "test4 passed!" << std::endl;
 }
 
+void test5() {
+    // Test range iteration and bounds
+    BitmappedBlockSkipList<uint64_t, int> skiplist(-1);
+    for (uint64_t i = 3; i < 200; i += 7) {
+        skiplist[i] = static_cast<int>(i);
+    }
+
+    long long sum = 0, expected = 0;
+    skiplist.forEachInRange(10, 150, [&sum](int value, uint64_t index) {
+        assert(index >= 10 && index < 150);
+        sum += value;
+        });
+    for (uint64_t i = 3; i < 200; i += 7) {
+        if (i >= 10 && i < 150) expected += static_cast<long long>(i);
+    }
+    assert(sum == expected);
+
+    assert(skiplist.someInRange(0, 200, [](int value, uint64_t) { return value == 52; }));
+    assert(!skiplist.someInRange(53, 59, [](int, uint64_t) { return true; }));
+    assert(skiplist.everyInRange(0, 200, [](int value, uint64_t index) { return value == static_cast<int>(index); }));
+
+    auto it = skiplist.lowerBound(11);
+    assert(it && it.key() == 17);
+    it = skiplist.lowerBound(17);
+    assert(it && it.key() == 17);
+    it = skiplist.upperBound(17);
+    assert(it && it.key() == 24);
+    --it;
+    assert(it && it.key() == 17);
+    --it;
+    assert(it && it.key() == 10);
+    assert(!skiplist.lowerBound(200));
+    assert(skiplist.lowerBound(0).key() == 3);
+
+    std::cout << "test5 passed!" << std::endl;
+}
+
+void test6() {
+    // Test concurrent readers on a shared const list
+    BitmappedBlockSkipList<uint64_t, int> skiplist(-1);
+    for (uint64_t i = 0; i < 10000; i += 3) {
+        skiplist[i] = static_cast<int>(i);
+    }
+    const auto& shared = skiplist;
+
+    std::vector<std::thread> readers;
+    std::vector<long long> sums(4, 0);
+    for (size_t t = 0; t < sums.size(); ++t) {
+        readers.emplace_back([&shared, &sums, t]() {
+            BitmappedBlockSkipList<uint64_t, int>::ReadFinger finger;
+            long long sum = 0;
+            for (uint64_t i = 0; i < 10000; ++i) {
+                if (shared.has(i, finger)) sum += shared.get(i, finger);
+                assert(shared[i] == ((i % 3 == 0) ? static_cast<int>(i) : -1));
+            }
+            sums[t] = sum;
+            });
+    }
+    for (auto& reader : readers) reader.join();
+
+    for (size_t t = 1; t < sums.size(); ++t) {
+        assert(sums[t] == sums[0]);
+    }
+
+    // finger is dropped after structural changes
+    BitmappedBlockSkipList<uint64_t, int>::ReadFinger finger;
+    assert(shared.get(9, finger) == 9);
+    for (uint64_t i = 0; i < 16; i += 3) skiplist.erase(i);
+    assert(shared.get(9, finger) == -1);
+    assert(shared.get(18, finger) == 18);
+
+    std::cout << "test6 passed!" << std::endl;
+}
+
+template<typename bitMap_t>
+void test_block_width() {
+    // Test every operation against a std::map for one block width
+    BitmappedBlockSkipList<uint64_t, int, bitMap_t> skiplist(-1);
+    std::map<uint64_t, int> expected;
+    uint64_t seed = 12345;
+    for (uint64_t i = 0; i < 20000; ++i) {
+        seed = seed * 6364136223846793005ULL + 1;
+        uint64_t idx = (seed >> 33) % 5000;
+        if (i % 3 == 2) {
+            skiplist.erase(idx);
+            expected.erase(idx);
+        }
+        else {
+            skiplist[idx] = static_cast<int>(i);
+            expected[idx] = static_cast<int>(i);
+        }
+    }
+
+    auto mit = expected.begin();
+    for (auto it = skiplist.begin(); it != skiplist.end(); ++it, ++mit) {
+        assert(mit != expected.end() && it.key() == mit->first && *it == mit->second);
+    }
+    assert(mit == expected.end());
+
+    auto rmit = expected.rbegin();
+    for (auto it = skiplist.rbegin(); it != skiplist.rend(); ++it, ++rmit) {
+        // a reverse iterator refers to the element before its base
+        assert(rmit != expected.rend() && std::prev(it.base()).key() == rmit->first && *it == rmit->second);
+    }
+    assert(rmit == expected.rend());
+
+    for (uint64_t i = 0; i < 5000; ++i) {
+        assert(skiplist.has(i) == (expected.count(i) != 0));
+    }
+}
+
+void test7() {
+    // Test every supported block width
+    test_block_width<uint8_t>();
+    test_block_width<uint16_t>();
+    test_block_width<uint32_t>();
+    test_block_width<uint64_t>();
+    static_assert(BitmappedBlockSkipList<uint64_t, int, uint64_t>::capacity_count == 64);
+    static_assert(BitmappedBlockSkipList<uint64_t, int, uint8_t>::capacity_count == 8);
+
+    std::cout << "test7 passed!" << std::endl;
+}
+
+void test8() {
+    // Test bulk load from sorted input
+    std::map<uint64_t, int> source;
+    for (uint64_t i = 0; i < 50000; i += (i % 7) + 1) {
+        source[i] = static_cast<int>(i * 3);
+    }
+
+    BitmappedBlockSkipList<uint64_t, int> skiplist(-1);
+    skiplist[123456789] = 1; // replaced by assign
+    skiplist.assign(source.begin(), source.end());
+    assert(!skiplist.has(123456789));
+
+    auto mit = source.begin();
+    for (auto it = skiplist.begin(); it != skiplist.end(); ++it, ++mit) {
+        assert(it.key() == mit->first && *it == mit->second);
+    }
+    assert(mit == source.end());
+
+    // the built list must keep working as a normal skip list
+    for (uint64_t i = 0; i < 50000; ++i) {
+        assert(skiplist.has(i) == (source.count(i) != 0));
+        if (i % 5 == 0) {
+            skiplist.erase(i);
+            source.erase(i);
+        }
+        else if (i % 5 == 1) {
+            skiplist[i] = -2;
+            source[i] = -2;
+        }
+    }
+    mit = source.begin();
+    for (auto it = skiplist.begin(); it != skiplist.end(); ++it, ++mit) {
+        assert(it.key() == mit->first && *it == mit->second);
+    }
+    assert(mit == source.end());
+
+    // dense assign
+    std::vector<int> values(1000);
+    for (size_t i = 0; i < values.size(); ++i) values[i] = static_cast<int>(i);
+    skiplist.assign(10, values.begin(), values.end());
+    for (uint64_t i = 0; i < 1020; ++i) {
+        assert(skiplist.has(i) == (i >= 10 && i < 1010));
+        if (skiplist.has(i)) assert(skiplist[i] == static_cast<int>(i - 10));
+    }
+
+    std::cout << "test8 passed!" << std::endl;
+}
+
+void test9() {
+    // Test batched lookup / write / erase with finger search
+    BitmappedBlockSkipList<uint64_t, int> skiplist(-1);
+    std::map<uint64_t, int> expected;
+
+    std::vector<uint64_t> keys;
+    std::vector<int> values;
+    uint64_t seed = 2024;
+    for (uint64_t i = 0; i < 30000; ++i) {
+        seed = seed * 6364136223846793005ULL + 1;
+        keys.push_back((seed >> 33) % 100000);
+        values.push_back(static_cast<int>(i));
+    }
+
+    // unsorted first, then sorted
+    skiplist.setMany(keys.data(), values.data(), keys.size() / 2);
+    for (size_t i = 0; i < keys.size() / 2; ++i) expected[keys[i]] = values[i];
+    std::sort(keys.begin() + keys.size() / 2, keys.end());
+    skiplist.setMany(keys.data() + keys.size() / 2, values.data() + keys.size() / 2, keys.size() - keys.size() / 2);
+    for (size_t i = keys.size() / 2; i < keys.size(); ++i) expected[keys[i]] = values[i];
+
+    std::vector<uint64_t> probe(100000);
+    for (uint64_t i = 0; i < probe.size(); ++i) probe[i] = i;
+    std::vector<int> out(probe.size());
+    skiplist.getMany(probe.data(), probe.size(), out.data());
+    for (uint64_t i = 0; i < probe.size(); ++i) {
+        auto it = expected.find(i);
+        assert(out[i] == ((it != expected.end()) ? it->second : -1));
+    }
+
+    std::vector<uint64_t> eraseKeys;
+    for (uint64_t i = 0; i < 100000; i += 2) eraseKeys.push_back(i);
+    size_t erasedExpected = 0;
+    for (auto key : eraseKeys) erasedExpected += expected.erase(key);
+    assert(skiplist.eraseMany(eraseKeys.data(), eraseKeys.size()) == erasedExpected);
+
+    // single key operations must keep working on the reused path
+    for (uint64_t i = 0; i < 100000; i += 3) {
+        skiplist[i] = 7;
+        expected[i] = 7;
+    }
+    auto mit = expected.begin();
+    for (auto it = skiplist.begin(); it != skiplist.end(); ++it, ++mit) {
+        assert(it.key() == mit->first && *it == mit->second);
+    }
+    assert(mit == expected.end());
+
+    std::cout << "test9 passed!" << std::endl;
+}
+
+void test10() {
+    // Test block-wise reductions on dense, partial and empty lists
+    BitmappedBlockSkipList<uint64_t, int> skiplist(-1);
+    assert(skiplist.count() == 0 && skiplist.sum() == 0);
+    assert(skiplist.min() == -1 && skiplist.max() == -1);
+
+    long long expectedSum = 0;
+    int expectedMin = INT32_MAX, expectedMax = INT32_MIN;
+    uint64_t expectedCount = 0, expectedXor = 0;
+    for (uint64_t i = 0; i < 5000; ++i) {
+        if (i % 7 == 3 || (i > 1000 && i < 2000)) {
+            int value = static_cast<int>((i * 37) % 1001) - 500;
+            skiplist[i] = value;
+            expectedSum += value;
+            expectedMin = std::min(expectedMin, value);
+            expectedMax = std::max(expectedMax, value);
+            expectedXor ^= static_cast<uint64_t>(value);
+            ++expectedCount;
+        }
+    }
+    assert(skiplist.count() == expectedCount);
+    assert(skiplist.sum<long long>() == expectedSum);
+    assert(skiplist.min() == expectedMin);
+    assert(skiplist.max() == expectedMax);
+    assert(skiplist.reduce(0ULL, [](uint64_t a, uint64_t b) { return a ^ b; }) == expectedXor);
+
+    // an erased value stays in its slot, it must not reach op: INT64_MAX + INT64_MAX would overflow
+    BitmappedBlockSkipList<int64_t, int64_t> stale(0);
+    stale[1] = INT64_MAX;
+    stale[16] = 0;
+    stale[17] = INT64_MAX;
+    stale.erase(17);
+    assert(stale.sum() == INT64_MAX);
+    assert(stale.parallelReduce(int64_t(0), [](int64_t a, int64_t b) { return a + b; }) == INT64_MAX);
+
+    BitmappedBlockSkipList<uint64_t, double, uint64_t> doubles(std::nan(""));
+    for (uint64_t i = 0; i < 1000; i += 3) doubles[i] = 0.5;
+    assert(doubles.sum() == 0.5 * 334);
+    assert(doubles.min() == 0.5 && doubles.max() == 0.5);
+
+    std::cout << "test10 passed!" << std::endl;
+}
+
+void test11() {
+    // Test block visitor
+    BitmappedBlockSkipList<uint64_t, int> skiplist(-1);
+    for (uint64_t i = 5; i < 300; i += 4) skiplist[i] = static_cast<int>(i);
+
+    uint64_t lastBase = 0, blocks = 0;
+    long long sum = 0;
+    skiplist.forEachBlock([&](uint64_t baseIndex, uint16_t bitMap, int* elements) {
+        assert(blocks == 0 || baseIndex > lastBase);
+        assert(baseIndex % skiplist.capacity_count == 0 && bitMap != 0);
+        for (uint64_t i = 0; i < skiplist.capacity_count; ++i) {
+            if ((bitMap >> i) & 1) {
+                assert(elements[i] == static_cast<int>(baseIndex + i));
+                elements[i] *= 2;
+            }
+        }
+        lastBase = baseIndex;
+        ++blocks;
+        });
+
+    const auto& constList = skiplist;
+    constList.forEachBlock([&](uint64_t, uint16_t bitMap, const int* elements) {
+        for (uint64_t i = 0; i < constList.capacity_count; ++i) {
+            if ((bitMap >> i) & 1) sum += elements[i];
+        }
+        });
+
+    long long expected = 0;
+    for (uint64_t i = 5; i < 300; i += 4) expected += static_cast<long long>(i) * 2;
+    assert(sum == expected);
+    assert(blocks == (300 + 15) / 16);
+
+    std::cout << "test11 passed!" << std::endl;
+}
+
+void test12() {
+    // Test the prefetching configuration behaves exactly like the default one
+    BitmappedBlockSkipList<uint64_t, int> plain(-1);
+    BitmappedBlockSkipList<uint64_t, int, uint16_t, PrefetchOptions> prefetched(-1);
+    for (uint64_t i = 0; i < 20000; i += 3) {
+        plain[i] = static_cast<int>(i);
+        prefetched[i] = static_cast<int>(i);
+    }
+    for (uint64_t i = 0; i < 20000; ++i) {
+        assert(plain.has(i) == prefetched.has(i));
+        assert(plain[i] == prefetched[i]);
+    }
+
+    long long sum1 = 0, sum2 = 0, sum3 = 0;
+    plain.forEach([&sum1](int value, uint64_t) { sum1 += value; });
+    prefetched.forEach([&sum2](int value, uint64_t) { sum2 += value; });
+    for (auto it = prefetched.begin(); it != prefetched.end(); ++it) sum3 += *it;
+    assert(sum1 == sum2 && sum2 == sum3 && sum3 == prefetched.sum<long long>());
+
+    std::cout << "test12 passed!" << std::endl;
+}
+
+template<typename List>
+void check_same_content(const List& list, const std::map<uint64_t, int>& expected) {
+    auto mit = expected.begin();
+    bool ok = list.every([&mit, &expected](int value, uint64_t index) {
+        bool same = mit != expected.end() && mit->first == index && mit->second == value;
+        ++mit;
+        return same;
+        });
+    assert(ok && mit == expected.end());
+}
+
+void test13() {
+    // Test copy, move, swap and clear
+    using List = BitmappedBlockSkipList<uint64_t, int>;
+    std::map<uint64_t, int> expectedA, expectedB;
+    List a(-1), b(-2);
+    for (uint64_t i = 0; i < 40000; i += 3) {
+        a[i] = static_cast<int>(i);
+        expectedA[i] = static_cast<int>(i);
+    }
+    b[7] = 7;
+    expectedB[7] = 7;
+
+    // deep copy is independent
+    List copy(a);
+    check_same_content(copy, expectedA);
+    copy[1] = 1;
+    copy.erase(0);
+    assert(a.has(0) && !a.has(1));
+    check_same_content(a, expectedA);
+
+    // move leaves the source empty but usable
+    static_assert(std::is_nothrow_move_constructible_v<List>);
+    List moved(std::move(copy));
+    assert(moved.has(1) && !moved.has(0));
+    assert(!copy.has(3) && copy.count() == 0);
+    // the pools went along, the source makes new ones on its next insert
+    assert(copy.stats().nodeSlabs == 0 && copy.stats().towerSlabs == 0 && moved.stats().nodeSlabs > 0);
+    copy[5] = 5;
+    assert(copy.has(5) && copy[5] == 5);
+
+    // swap exchanges everything, including the empty sentinel chains
+    List empty(-3);
+    a.swap(b);
+    check_same_content(a, expectedB);
+    check_same_content(b, expectedA);
+    assert(a[100] == -2 && b[100] == -1);
+    a.erase(100);
+    b.erase(100);
+    b.swap(empty);
+    check_same_content(empty, expectedA);
+    assert(b.count() == 0 && !b.has(0));
+    b[3] = 3;
+    assert(b.has(3));
+
+    // assignments
+    List assigned(-1);
+    assigned = empty;
+    check_same_content(assigned, expectedA);
+    assigned = assigned;
+    check_same_content(assigned, expectedA);
+    List target(-1);
+    target = std::move(assigned);
+    check_same_content(target, expectedA);
+    assert(assigned.count() == 0);
+
+    // clear keeps the list usable
+    target.clear();
+    assert(target.count() == 0 && target.begin() == target.end());
+    for (uint64_t i = 0; i < 1000; ++i) target[i] = 1;
+    assert(target.count() == 1000);
+
+    std::cout << "test13 passed!" << std::endl;
+}
+
+void test14() {
+    // Test O(1) size and stats
+    BitmappedBlockSkipList<uint64_t, int> skiplist(-1);
+    std::map<uint64_t, int> expected;
+    assert(skiplist.size() == 0 && skiplist.empty());
+
+    uint64_t seed = 77;
+    for (uint64_t i = 0; i < 50000; ++i) {
+        seed = seed * 6364136223846793005ULL + 1;
+        uint64_t idx = (seed >> 33) % 20000;
+        if (i % 4 == 3) {
+            skiplist.erase(idx);
+            expected.erase(idx);
+        }
+        else {
+            skiplist[idx] = 1;
+            expected[idx] = 1;
+        }
+        assert(skiplist.size() == expected.size());
+    }
+
+    std::vector<uint64_t> keys = { 1, 2, 3, 30000, 30001 };
+    std::vector<int> values = { 1, 1, 1, 1, 1 };
+    skiplist.setMany(keys.data(), values.data(), keys.size());
+    for (auto key : keys) expected[key] = 1;
+    assert(skiplist.size() == expected.size());
+    keys.push_back(99999);
+    skiplist.eraseMany(keys.data(), keys.size());
+    for (auto key : keys) expected.erase(key);
+    assert(skiplist.size() == expected.size());
+
+    auto stats = skiplist.stats();
+    assert(stats.elements == expected.size());
+    uint64_t histogramTotal = 0;
+    for (auto count : stats.levelHistogram) histogramTotal += count;
+    assert(histogramTotal == stats.blocks);
+    assert(stats.averageFill > 0 && stats.averageFill <= 1);
+    assert(stats.nodeBytes > 0 && stats.nodeSlabs > 0);
+    // a list that stays on the inline levels never makes the tower pool
+    BitmappedBlockSkipList<uint64_t, int> small(-1);
+    for (uint64_t i = 0; i < 64; ++i) small[i] = 1;
+    assert(small.stats().towerSlabs == 0 && small.stats().towerBytes == 0 && skiplist.stats().towerSlabs > 0);
+
+    skiplist.assign(expected.begin(), expected.end());
+    assert(skiplist.size() == expected.size());
+    BitmappedBlockSkipList<uint64_t, int> copy(skiplist);
+    assert(copy.size() == expected.size());
+    copy.clear();
+    assert(copy.size() == 0 && copy.stats().blocks == 0);
+
+    std::cout << "test14 passed!" << std::endl;
+}
+
+void test15() {
+    // Test compact and compactStep against std::map
+    using List = BitmappedBlockSkipList<uint64_t, int>;
+    List skiplist(-1);
+    std::map<uint64_t, int> expected;
+
+    // churn leaves half full blocks, each run of 16 keys straddles two aligned blocks
+    for (uint64_t i = 0; i < 64000; ++i) {
+        skiplist[i] = static_cast<int>(i);
+        expected[i] = static_cast<int>(i);
+    }
+    for (uint64_t i = 0; i < 64000; ++i) {
+        if ((i + 8) % 32 >= 16) {
+            skiplist.erase(i);
+            expected.erase(i);
+        }
+    }
+
+    const uint64_t blocksBefore = skiplist.stats().blocks;
+    const uint64_t freed = skiplist.compact();
+    const auto stats = skiplist.stats();
+    assert(stats.blocks == blocksBefore - freed && stats.blocks * 2 <= blocksBefore + 2);
+    assert(stats.averageFill > 0.95);
+    assert(skiplist.size() == expected.size());
+    check_same_content(skiplist, expected);
+
+    // lookups, fingers, ranges and bounds on unaligned blocks
+    List::ReadFinger finger;
+    for (uint64_t i = 0; i < 64000; ++i) {
+        const bool present = expected.count(i) != 0;
+        assert(skiplist.has(i) == present);
+        assert(skiplist.has(i, finger) == present);
+        assert(skiplist.get(i, finger) == (present ? expected[i] : -1));
+    }
+    uint64_t rangeCount = 0;
+    skiplist.forEachInRange(1000, 2000, [&rangeCount](int value, uint64_t index) {
+        assert(value == static_cast<int>(index) && (index + 8) % 32 < 16);
+        ++rangeCount;
+        });
+    assert(rangeCount == static_cast<uint64_t>(std::distance(expected.lower_bound(1000), expected.lower_bound(2000))));
+    assert(skiplist.lowerBound(1001).key() == 1016 && skiplist.lowerBound(1016).key() == 1016);
+
+    // the list keeps working after compaction, incremental passes interleave with writes
+    uint64_t seed = 99;
+    for (uint64_t i = 0; i < 40000; ++i) {
+        seed = seed * 6364136223846793005ULL + 1;
+        const uint64_t idx = (seed >> 33) % 70000;
+        if (i % 3 == 0) {
+            skiplist.erase(idx);
+            expected.erase(idx);
+        }
+        else {
+            skiplist[idx] = static_cast<int>(idx);
+            expected[idx] = static_cast<int>(idx);
+        }
+        if (i % 100 == 0) skiplist.compactStep(4, 8);
+        if (i % 7 == 0) assert(skiplist.get(idx, finger) == (expected.count(idx) ? expected[idx] : -1));
+    }
+    while (!skiplist.compactStep(4, 8)) {}
+    assert(skiplist.size() == expected.size());
+    check_same_content(skiplist, expected);
+    for (const auto& [index, value] : expected) {
+        assert(skiplist[index] == value);
+    }
+
+    std::cout << "test15 passed!" << std::endl;
+}
+
+struct ExtentOptions : bbsl::DefaultOptions {
+    static constexpr uint16_t extent_blocks = 4;
+};
+
+void test16() {
+    // Test extents: promotion, lookups, holes, dissolving and compact()
+    using List = BitmappedBlockSkipList<uint64_t, int>;
+    List skiplist(-1);
+    std::map<uint64_t, int> expected;
+
+    for (uint64_t i = 0; i < 50000; ++i) {
+        skiplist[i] = static_cast<int>(i);
+        expected[i] = static_cast<int>(i);
+    }
+    // a sparse tail and a gap keep two runs apart
+    for (uint64_t i = 20000; i < 20016; ++i) {
+        skiplist.erase(i);
+        expected.erase(i);
+    }
+    for (uint64_t i = 60000; i < 90000; i += 100) {
+        skiplist[i] = 1;
+        expected[i] = 1;
+    }
+
+    assert(skiplist.promoteExtents(8) == 2);
+    auto stats = skiplist.stats();
+    assert(stats.extents == 2 && stats.extentBytes > 0);
+    assert(stats.levelHistogram[0] >= 49000 / List::capacity_count);
+    check_same_content(skiplist, expected);
+
+    List::ReadFinger finger;
+    for (uint64_t i = 0; i < 91000; i += 7) {
+        const int want = expected.count(i) ? expected[i] : -1;
+        assert(skiplist.get(i, finger) == want);
+        assert(static_cast<const List&>(skiplist)[i] == want);
+    }
+    assert(skiplist.lowerBound(20000).key() == 20016);
+    assert(skiplist.sum<int64_t>() == std::accumulate(expected.begin(), expected.end(), int64_t(0),
+        [](int64_t acc, const std::pair<const uint64_t, int>& item) { return acc + item.second; }));
+
+    // holes stay inside the extent, an empty block dissolves it
+    skiplist.erase(100);
+    expected.erase(100);
+    assert(skiplist.stats().extents == 2);
+    for (uint64_t i = 32; i < 48; ++i) {
+        skiplist.erase(i);
+        expected.erase(i);
+    }
+    assert(skiplist.stats().extents == 1);
+    check_same_content(skiplist, expected);
+
+    // writes on either side, batches, copy and swap
+    std::vector<uint64_t> keys = { 40, 30000, 30001, 49999, 50000, 50001 };
+    std::vector<int> values(keys.size(), 5);
+    skiplist.setMany(keys.data(), values.data(), keys.size());
+    for (auto key : keys) expected[key] = 5;
+    keys = { 25000, 25001, 99999 };
+    skiplist.eraseMany(keys.data(), keys.size());
+    for (auto key : keys) expected.erase(key);
+    check_same_content(skiplist, expected);
+    assert(skiplist.size() == expected.size());
+
+    List copy(skiplist);
+    check_same_content(copy, expected);
+    List other(-1);
+    other.swap(skiplist);
+    check_same_content(other, expected);
+    assert(other.stats().extents == 1 && skiplist.empty());
+
+    // compact() promotes by itself when the options ask for it
+    BitmappedBlockSkipList<uint64_t, int, uint16_t, ExtentOptions> dense(-1);
+    for (uint64_t i = 0; i < 1000; ++i) dense[i] = 1;
+    dense.compact();
+    assert(dense.stats().extents == 1 && dense.count() == 1000);
+    for (uint64_t i = 0; i < 1000; ++i) dense.erase(i);
+    assert(dense.empty() && dense.stats().extents == 0);
+
+    other.clear();
+    assert(other.stats().extents == 0 && other.empty());
+
+    std::cout << "test16 passed!" << std::endl;
+}
+
+struct SmallCacheOptions : bbsl::DefaultOptions {
+    static constexpr uint32_t index_cache_slots = 64;
+};
+
+void test17() {
+    // Test the index cache stays coherent through inserts, erases, compaction and extents
+    using List = BitmappedBlockSkipList<uint64_t, int, uint16_t, SmallCacheOptions>;
+    List skiplist(-1);
+    std::map<uint64_t, int> expected;
+    const List& view = skiplist;
+
+    uint64_t seed = 2024;
+    for (uint64_t round = 0; round < 6; ++round) {
+        for (uint64_t i = 0; i < 30000; ++i) {
+            seed = seed * 6364136223846793005ULL + 1;
+            const uint64_t idx = (seed >> 33) % 8000;
+            switch (i % 4) {
+            case 0:
+                assert(skiplist.erase(idx) == (expected.erase(idx) != 0));
+                break;
+            case 1:
+                assert(view[idx] == (expected.count(idx) ? expected[idx] : -1));
+                assert(view.has(idx) == (expected.count(idx) != 0));
+                break;
+            default:
+                skiplist[idx] = static_cast<int>(i);
+                expected[idx] = static_cast<int>(i);
+                break;
+            }
+        }
+        // move or free the cached blocks
+        if (round % 2 == 0) skiplist.compact();
+        else {
+            for (uint64_t i = 2000; i < 3000; ++i) {
+                skiplist[i] = 1;
+                expected[i] = 1;
+            }
+            skiplist.promoteExtents(4);
+        }
+        assert(skiplist.size() == expected.size());
+    }
+    check_same_content(skiplist, expected);
+    for (uint64_t i = 0; i < 8000; ++i) {
+        assert(view[i] == (expected.count(i) ? expected[i] : -1));
+    }
+
+    List other(-1);
+    other.swap(skiplist);
+    assert(skiplist.empty() && !skiplist.has(2500) && other.has(2500));
+    other.clear();
+    assert(!other.has(2500) && other[2500] == -1);
+
+    std::cout << "test17 passed!" << std::endl;
+}
+
+void test18() {
+    // Test the concurrent list: writers share blocks, readers run lock free next to them
+    ConcurrentBitmappedBlockSkipList<uint64_t, int> shared(-1);
+    const uint64_t range = 6000;
+    const size_t writerCount = 4;
+    std::vector<std::map<uint64_t, int>> owned(writerCount);
+    std::atomic<bool> done{ false };
+
+    std::vector<std::thread> readers;
+    for (size_t t = 0; t < 3; ++t) {
+        readers.emplace_back([&shared, &done, t]() {
+            uint64_t seed = 31 + t;
+            while (!done.load()) {
+                seed = seed * 6364136223846793005ULL + 1;
+                const uint64_t idx = (seed >> 33) % range;
+                const int value = shared.get(idx);
+                // every writer stores the index into its own slots
+                assert(value == -1 || value == static_cast<int>(idx));
+                uint64_t previous = 0;
+                bool first = true;
+                if ((seed & 63) == 0) {
+                    shared.forEach([&previous, &first](int value, uint64_t index) {
+                        assert(value == static_cast<int>(index) && (first || previous < index));
+                        previous = index;
+                        first = false;
+                        });
+                }
+            }
+            });
+    }
+
+    std::vector<std::thread> writers;
+    for (size_t t = 0; t < writerCount; ++t) {
+        writers.emplace_back([&shared, &owned, t]() {
+            // writer t owns the indices with index % writerCount == t, so every block has several writers
+            uint64_t seed = 7 + t;
+            for (uint64_t i = 0; i < 60000; ++i) {
+                seed = seed * 6364136223846793005ULL + 1;
+                const uint64_t idx = ((seed >> 33) % (range / writerCount)) * writerCount + t;
+                if ((seed >> 20) % 3 == 0) {
+                    assert(shared.erase(idx) == (owned[t].erase(idx) != 0));
+                }
+                else {
+                    shared.set(idx, static_cast<int>(idx));
+                    owned[t][idx] = static_cast<int>(idx);
+                }
+            }
+            });
+    }
+    for (auto& writer : writers) writer.join();
+    done.store(true);
+    for (auto& reader : readers) reader.join();
+
+    std::map<uint64_t, int> expected;
+    for (const auto& part : owned) expected.insert(part.begin(), part.end());
+    assert(shared.size() == expected.size());
+    auto it = expected.begin();
+    shared.forEach([&it, &expected](int value, uint64_t index) {
+        assert(it != expected.end() && it->first == index && it->second == value);
+        ++it;
+        });
+    assert(it == expected.end());
+    for (uint64_t i = 0; i < range; ++i) {
+        assert(shared.has(i) == (expected.count(i) != 0));
+    }
+
+    // erasing everything frees every block once the readers are gone
+    for (const auto& item : expected) shared.erase(item.first);
+    shared.collect();
+    assert(shared.size() == 0 && !shared.has(expected.begin()->first));
+
+    std::cout << "test18 passed!" << std::endl;
+}
+
+void test19() {
+    // Test the shared pool: per thread caches, frees from other threads
+    struct Item {
+        uint64_t owner;
+        uint64_t stamp;
+    };
+    slab::SharedObjectPool<Item> pool;
+    std::mutex handoffLock;
+    std::vector<Item*> handoff;
+    std::atomic<uint64_t> freed{ 0 };
+    const size_t threadCount = 4;
+    const uint64_t perThread = 20000;
+
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threadCount; ++t) {
+        workers.emplace_back([&, t]() {
+            slab::SharedObjectPool<Item>::Cache cache(pool);
+            std::vector<Item*> mine;
+            for (uint64_t i = 0; i < perThread; ++i) {
+                Item* item = cache.create(Item{ t, i });
+                mine.push_back(item);
+                if (mine.size() == 64) {
+                    // every live item still holds what its owner wrote
+                    for (uint64_t k = 0; k < mine.size(); ++k) assert(mine[k]->owner == t);
+                    // hand half of them to whoever frees next, keep the rest local
+                    std::lock_guard<std::mutex> guard(handoffLock);
+                    for (size_t k = 0; k < 32; ++k) handoff.push_back(mine[k]);
+                    for (size_t k = 32; k < 64; ++k) {
+                        cache.destroy(mine[k]);
+                        ++freed;
+                    }
+                    mine.clear();
+                }
+                if (i % 100 == 0) {
+                    std::vector<Item*> taken;
+                    {
+                        std::lock_guard<std::mutex> guard(handoffLock);
+                        taken.swap(handoff);
+                    }
+                    for (Item* item : taken) {
+                        assert(item->owner < threadCount && item->stamp < perThread);
+                        cache.destroy(item);
+                        ++freed;
+                    }
+                }
+            }
+            for (Item* item : mine) {
+                cache.destroy(item);
+                ++freed;
+            }
+            });
+    }
+    for (auto& worker : workers) worker.join();
+
+    {
+        slab::SharedObjectPool<Item>::Cache cache(pool);
+        for (Item* item : handoff) {
+            cache.destroy(item);
+            ++freed;
+        }
+    }
+    assert(freed == threadCount * perThread);
+    assert(pool.total() >= 1);
+
+    // without a cache every call takes the lock
+    void* raw = pool.allocate();
+    pool.deallocate(raw);
+
+    std::cout << "test19 passed!" << std::endl;
+}
+
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t live = 0;
+    size_t calls = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        live += bytes;
+        ++calls;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        live -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+void test20() {
+    // Test slabs and extents coming from a memory resource
+    using List = BitmappedBlockSkipList<uint64_t, int>;
+    CountingResource counting;
+    {
+        List skiplist(-1, &counting);
+        // the pools are made on the first insert
+        assert(skiplist.resource() == &counting && counting.live == 0);
+        for (uint64_t i = 0; i < 20000; ++i) skiplist[i * 2] = static_cast<int>(i);
+        assert(counting.live > 0);
+        for (uint64_t i = 40000; i < 50000; ++i) skiplist[i] = 1;
+        const size_t beforeExtents = counting.live;
+        assert(skiplist.promoteExtents(4) == 1 && counting.live > beforeExtents);
+
+        List plain(skiplist);
+        assert(plain.resource() == nullptr && plain.size() == skiplist.size());
+        List placed(skiplist, &counting);
+        assert(placed.resource() == &counting && placed.size() == skiplist.size());
+
+        // assignment keeps the resource of the target, move takes the pools along
+        plain = placed;
+        assert(plain.resource() == nullptr && plain.size() == skiplist.size());
+        List moved(std::move(placed));
+        assert(moved.resource() == &counting && moved.size() == skiplist.size());
+
+        // dissolving an extent gives its memory back
+        for (uint64_t i = 40000; i < 40016; ++i) skiplist.erase(i);
+        moved.clear();
+        assert(skiplist.stats().extents == 0);
+    }
+    assert(counting.live == 0 && counting.calls > 0);
+
+    // a monotonic arena dropped in one go
+    {
+        std::pmr::monotonic_buffer_resource arena(1 << 20);
+        List skiplist(-1, &arena);
+        for (uint64_t i = 0; i < 30000; ++i) skiplist[i * 3] = static_cast<int>(i);
+        assert(skiplist[2997] == 999 && skiplist.size() == 30000);
+
+        slab::ObjectPool<uint64_t> pool(4, &arena);
+        uint64_t* value = pool.allocate(42);
+        assert(*value == 42);
+        pool.deallocate(value);
+    }
+
+    std::cout << "test20 passed!" << std::endl;
+}
+
+void test21() {
+    // Test slabs with several bitmap words and the growth policy
+    slab::ObjectPool<uint64_t> pool(1, nullptr, slab::SlabGeometry{ 100, 4096 });
+    assert(pool.total() == 1);
+
+    std::vector<uint64_t*> units;
+    for (uint64_t i = 0; i < 20000; ++i) units.push_back(pool.allocate(i));
+    // 128 + 256 + ... + 4096, then 4096 per slab
+    assert(pool.total() <= 9);
+    std::vector<uint64_t*> sorted(units);
+    std::sort(sorted.begin(), sorted.end());
+    assert(std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+
+    // free in a scattered order, then reuse every hole
+    uint64_t seed = 5;
+    for (size_t i = units.size() - 1; i > 0; --i) {
+        seed = seed * 6364136223846793005ULL + 1;
+        std::swap(units[i], units[(seed >> 33) % (i + 1)]);
+    }
+    for (size_t i = 0; i < units.size(); i += 2) {
+        assert(*units[i] < 20000);
+        pool.deallocate(units[i]);
+    }
+    const uint32_t slabs = pool.total();
+    for (size_t i = 0; i < units.size(); i += 2) units[i] = pool.allocate(i);
+    assert(pool.total() == slabs);
+    for (auto unit : units) pool.deallocate(unit);
+    // empty slabs beyond the reserve go back upstream
+    assert(pool.total() == 1 && pool.reserved() == 1 && pool.bytes() > 0);
+
+    pool.reset();
+    assert(pool.total() == 1);
+
+    std::cout << "test21 passed!" << std::endl;
+}
+
+struct Counted {
+    static inline int alive = 0;
+    uint64_t value;
+    Counted(uint64_t v) : value(v) { ++alive; }
+    ~Counted() { --alive; }
+};
+
+void test22() {
+    // Test teardown: live objects are destroyed exactly once, trivial ones never visited
+    {
+        slab::ObjectPool<Counted> pool(2, nullptr, slab::SlabGeometry{ 64, 1024 });
+        std::vector<Counted*> objects;
+        for (uint64_t i = 0; i < 3000; ++i) objects.push_back(pool.allocate(i));
+        // holes in every word, the walk must only touch the allocated bits
+        for (size_t i = 0; i < objects.size(); i += 3) pool.deallocate(objects[i]);
+        assert(Counted::alive == 2000);
+
+        pool.reset();
+        assert(Counted::alive == 0 && pool.total() <= 2);
+
+        for (uint64_t i = 0; i < 500; ++i) pool.allocate(i);
+        assert(Counted::alive == 500);
+    }
+    assert(Counted::alive == 0);
+
+    // the list drops whole slabs on destruction and on clear
+    {
+        bbsl::BitmappedBlockSkipList<uint64_t, uint64_t> list(~0ULL);
+        for (uint64_t i = 0; i < 200000; ++i) list[i * 7] = i;
+        list.clear();
+        assert(list.size() == 0);
+        for (uint64_t i = 0; i < 1000; ++i) list[i] = i;
+        assert(list.size() == 1000 && list[999] == 999);
+    }
+
+    std::cout << "test22 passed!" << std::endl;
+}
+
+void test23() {
+    // Test the counters of the list and of the pools
+    BitmappedBlockSkipList<uint64_t, uint64_t, uint16_t, bbsl::CounterOptions> list(~0ULL);
+    const uint64_t N = 100000;
+    for (uint64_t i = 0; i < N; ++i) list[i] = i;
+
+    auto counters = list.counters();
+    // one miss per new block, every other write lands in the block of the last path
+    const uint64_t blocks = N / 16;
+    assert(counters.nodeInserts == blocks && counters.nodeRemoves == 0);
+    assert(counters.fingerHits + counters.fingerMisses == N);
+    assert(counters.fingerMisses == blocks && counters.fingerHitRate() > 0.9);
+    assert(counters.descents == counters.fingerMisses && counters.descentHops > 0);
+    assert(counters.levelIncreases == static_cast<uint64_t>(list.getLevel()) && counters.levelDecreases == 0);
+
+    list.resetCounters();
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < N; i += 97) sum += static_cast<const decltype(list)&>(list)[i];
+    counters = list.counters();
+    assert(sum > 0 && counters.descents == (N + 96) / 97 && counters.nodeInserts == 0);
+
+    for (uint64_t i = 0; i < N; ++i) list.erase(i);
+    counters = list.counters();
+    assert(counters.nodeRemoves == blocks && counters.levelDecreases > 0);
+    assert(static_cast<int64_t>(counters.levelIncreases) - static_cast<int64_t>(counters.levelDecreases) < 0);
+
+    // the default options count nothing
+    BitmappedBlockSkipList<uint64_t, uint64_t> plain(~0ULL);
+    for (uint64_t i = 0; i < 1000; ++i) plain[i] = i;
+    assert(plain.counters().descents == 0 && plain.counters().fingerHits == 0);
+
+    // pool stats are structural, the slab counters need a counting pool
+    slab::ObjectPool<uint64_t> pool(1);
+    slab::ObjectPool<uint64_t, true> countingPool(1);
+    std::vector<uint64_t*> units, countedUnits;
+    for (uint64_t i = 0; i < 200; ++i) {
+        units.push_back(pool.allocate(i));
+        countedUnits.push_back(countingPool.allocate(i));
+    }
+    auto poolStats = pool.stats();
+    assert(poolStats.total == 4 && poolStats.full == 3 && poolStats.reserved == 0 && poolStats.bytes == pool.bytes());
+    assert(poolStats.allocations == 0 && poolStats.slabCreates == 0);
+    poolStats = countingPool.stats();
+    assert(poolStats.total == 4 && poolStats.allocations == 200 && poolStats.slabCreates == 4 && poolStats.peakBytes == countingPool.bytes());
+    for (auto unit : units) pool.deallocate(unit);
+    for (auto unit : countedUnits) countingPool.deallocate(unit);
+    poolStats = pool.stats();
+    assert(poolStats.total == 1 && poolStats.full == 0 && poolStats.reserved == 1 && poolStats.frees == 0);
+    poolStats = countingPool.stats();
+    assert(poolStats.frees == 200 && poolStats.slabDestroys == 3 && poolStats.peakBytes > countingPool.bytes());
+
+    auto listStats = plain.stats();
+    assert(listStats.nodePool.total == listStats.nodeSlabs && listStats.nodePool.bytes == listStats.nodeBytes);
+    assert(listStats.nodePool.allocations == 0);
+
+    // a counting list counts the traffic of its pools as well
+    BitmappedBlockSkipList<uint64_t, uint64_t, uint16_t, bbsl::CounterOptions> counted(~0ULL);
+    for (uint64_t i = 0; i < 1000; ++i) counted[i * 16] = i;
+    auto countedStats = counted.stats();
+    assert(countedStats.nodePool.allocations == 1000 && countedStats.nodePool.slabCreates > 0);
+    assert(countedStats.towerPool.allocations > 0);
+    counted.resetCounters();
+    assert(counted.stats().nodePool.allocations == 0 && counted.counters().nodeInserts == 0);
+
+    std::cout << "test23 passed!" << std::endl;
+}
+
+struct IndexedCounterOptions : bbsl::DefaultOptions {
+    static constexpr bool collect_counters = true;
+    static constexpr bool indexed_levels = true;
+};
+
+void test24() {
+    // Test level hysteresis around a power of 2 and the indexed levels
+    BitmappedBlockSkipList<uint64_t, uint64_t, uint16_t, bbsl::CounterOptions> list(~0ULL);
+    // one element per block, 1024 blocks take the level to 11
+    const uint64_t blocks = 1024;
+    for (uint64_t b = 0; b < blocks; ++b) list[b * 16] = b;
+    assert(list.getLevel() == 11);
+
+    const auto grown = list.counters();
+    for (int round = 0; round < 100; ++round) {
+        list.erase((blocks - 1) * 16);
+        list[(blocks - 1) * 16] = blocks - 1;
+    }
+    auto counters = list.counters();
+    assert(counters.levelIncreases == grown.levelIncreases && counters.levelDecreases == grown.levelDecreases);
+
+    // the level only drops once the width is below a quarter
+    for (uint64_t b = blocks - 1; b >= 300; --b) list.erase(b * 16);
+    assert(list.getLevel() < 11 && list.counters().levelDecreases > 0);
+    for (uint64_t b = 0; b < 300; ++b) assert(list.has(b * 16) && list[b * 16] == b);
+    assert(!list.has(300 * 16));
+
+    // indexed levels: the same keys give the same towers, a dense list is a perfect skip list
+    BitmappedBlockSkipList<uint64_t, uint64_t, uint16_t, IndexedCounterOptions> a(~0ULL, 1), b(~0ULL, 2);
+    const uint64_t N = 1 << 16;
+    for (uint64_t i = 0; i < N; ++i) a[i] = i;
+    std::vector<uint64_t> order(N);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937_64(24));
+    for (uint64_t i = 0; i < N; ++i) b[order[i]] = order[i];
+
+    const auto statsA = a.stats();
+    assert(statsA.blocks == N / 16 && statsA.level == a.getLevel());
+    for (int64_t l = 0; l < statsA.level; ++l) assert(statsA.levelHistogram[l] == (N / 16) >> (l + 1));
+
+    a.resetCounters();
+    const auto& constA = a;
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < N; ++i) sum += constA[order[i]];
+    assert(sum == N * (N - 1) / 2);
+    // one right move per level at most, plus the top level
+    assert(a.counters().hopsPerDescent() <= static_cast<double>(a.getLevel() + 1));
+
+    // random erase and reinsert against std::map
+    std::map<uint64_t, uint64_t> reference;
+    for (uint64_t i = 0; i < N; ++i) reference[order[i]] = order[i];
+    std::mt19937_64 rng(7);
+    for (int i = 0; i < 200000; ++i) {
+        const uint64_t key = rng() % (N * 2);
+        if (rng() & 1) {
+            b[key] = key + 1;
+            reference[key] = key + 1;
+        }
+        else {
+            assert(b.erase(key) == (reference.erase(key) == 1));
+        }
+    }
+    assert(b.size() == reference.size());
+    for (const auto& [key, value] : reference) assert(b.has(key) && b[key] == value);
+
+    std::cout << "test24 passed!" << std::endl;
+}
+
+void test25() {
+    // Test serialization and the mapped view
+    BitmappedBlockSkipList<int64_t, uint64_t, uint16_t, ExtentOptions> list(~0ULL);
+    std::map<int64_t, uint64_t> reference;
+    for (int64_t i = -5000; i < 20000; ++i) reference[i] = static_cast<uint64_t>(i * 3);
+    for (int64_t i = 0; i < 2000; ++i) reference[100000 + i * 37] = static_cast<uint64_t>(i);
+    for (const auto& [key, value] : reference) list[key] = value;
+    // unaligned bases and extents go through the format like any block
+    for (int64_t i = 100005; i < 100040; ++i) { list[i] = 7; reference[i] = 7; }
+    list.compact();
+    assert(list.stats().extents > 0);
+
+    std::stringstream stream;
+    assert(list.serialize(stream));
+
+    BitmappedBlockSkipList<int64_t, uint64_t> copy(~0ULL);
+    copy[1] = 1;
+    assert(copy.deserialize(stream));
+    assert(copy.size() == reference.size());
+    for (const auto& [key, value] : reference) assert(copy.has(key) && copy[key] == value);
+    assert(!copy.has(-5001) && !copy.has(100001));
+    // the list is usable afterwards
+    copy[-6000] = 1;
+    copy.erase(0);
+    assert(copy.size() == reference.size());
+
+    // a foreign layout, a truncated stream and a damaged record are refused
+    BitmappedBlockSkipList<int64_t, uint32_t> other(0);
+    std::stringstream again(stream.str());
+    assert(!other.deserialize(again) && other.size() == 0);
+    const std::string bytes = stream.str();
+    std::stringstream truncated(bytes.substr(0, bytes.size() / 2));
+    assert(!copy.deserialize(truncated) && copy.size() == 0);
+    std::string damaged = bytes;
+    damaged[sizeof(bbsl::format::FileHeader) + 8] = 0;
+    damaged[sizeof(bbsl::format::FileHeader) + 9] = 0;
+    std::stringstream broken(damaged);
+    assert(!copy.deserialize(broken));
+
+    // a block count whose directory size wraps around is refused by the header check
+    bbsl::format::FileHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    header.blockCount = (1ULL << 60) + 1;
+    header.fileBytes = header.directoryOffset + 16;
+    std::string wrapped = bytes;
+    std::memcpy(&wrapped[0], &header, sizeof(header));
+    std::stringstream wrappedStream(wrapped);
+    assert(!copy.deserialize(wrappedStream) && copy.size() == 0);
+
+    // a second base far above the first one must not overflow the signed distance
+    bbsl::format::BlockHeader first;
+    std::memcpy(&first, bytes.data() + sizeof(header), sizeof(first));
+    const uint64_t second = sizeof(header) + bbsl::format::recordBytes(bits::popcnt(first.bitMap), sizeof(uint64_t));
+    std::string hostile = bytes;
+    const uint64_t farBase = static_cast<uint64_t>(INT64_MAX);
+    std::memcpy(&hostile[second], &farBase, sizeof(farBase));
+    std::stringstream hostileStream(hostile);
+    assert(!copy.deserialize(hostileStream) && copy.size() == 0);
+
+    // the mapped view reads the same file without building anything
+    const char* path = "test25_bbsl.bin";
+    {
+        std::ofstream out(path, std::ios::binary);
+        assert(list.serialize(out));
+    }
+    {
+        bbsl::MappedBitmappedBlockSkipList<int64_t, uint64_t> view(~0ULL, path);
+        assert(view.isOpen() && view.verify());
+        assert(view.size() == reference.size() && view.blocks() == list.stats().blocks);
+        for (const auto& [key, value] : reference) assert(view.has(key) && view[key] == value);
+        assert(!view.has(-5001) && view[-5001] == ~0ULL && !view.has(100001) && !view.has(1LL << 40));
+
+        std::vector<std::pair<const int64_t, uint64_t>> visited;
+        view.forEach([&visited](uint64_t value, int64_t index) { visited.emplace_back(index, value); });
+        assert(std::equal(visited.begin(), visited.end(), reference.begin(), reference.end()));
+
+        uint64_t sum = 0, expected = 0;
+        view.forEachInRange(-100, 100010, [&sum](uint64_t value, int64_t) { sum += value; });
+        for (auto it = reference.lower_bound(-100); it != reference.end() && it->first < 100010; ++it) expected += it->second;
+        assert(sum == expected);
+
+        bbsl::MappedBitmappedBlockSkipList<int64_t, uint32_t> wrong(0);
+        assert(!wrong.open(path) && !wrong.isOpen());
+    }
+    std::remove(path);
+
+    // the only block sits at the bottom of the range, a query at the top must not overflow the signed distance
+    {
+        BitmappedBlockSkipList<int64_t, uint64_t> low(~0ULL);
+        low[INT64_MIN + 3] = 3;
+        std::ofstream out(path, std::ios::binary);
+        assert(low.serialize(out));
+    }
+    {
+        bbsl::MappedBitmappedBlockSkipList<int64_t, uint64_t> view(~0ULL, path);
+        assert(view.isOpen() && view[INT64_MIN + 3] == 3);
+        assert(!view.has(INT64_MAX) && !view.has(0) && view[INT64_MAX] == ~0ULL);
+    }
+    std::remove(path);
+
+    bbsl::MappedBitmappedBlockSkipList<int64_t, uint64_t> missing(0, "does_not_exist.bin");
+    assert(!missing.isOpen() && missing.size() == 0 && !missing.has(0));
+
+    std::cout << "test25 passed!" << std::endl;
+}
+
+template<typename index_t>
+void checkFrozen(uint64_t blocks, uint64_t stride) {
+    BitmappedBlockSkipList<index_t, uint64_t> list(~0ULL);
+    const index_t first = std::is_signed_v<index_t> ? static_cast<index_t>(-static_cast<int64_t>(blocks * stride / 2)) : 0;
+    for (uint64_t b = 0; b < blocks; ++b) {
+        const index_t base = static_cast<index_t>(first + static_cast<index_t>(b * stride));
+        list[base] = b;
+        list[base + 5] = b + 1;
+    }
+
+    const auto frozen = list.freeze();
+    assert(frozen.size() == list.size() && frozen.blockSize() == list.stats().blocks);
+    for (uint64_t b = 0; b < blocks; ++b) {
+        const index_t base = static_cast<index_t>(first + static_cast<index_t>(b * stride));
+        assert(frozen.has(base) && frozen[base] == b && frozen[base + 5] == b + 1);
+        assert(!frozen.has(base + 1) && frozen[base + 1] == ~0ULL);
+        if (stride > 16) assert(!frozen.has(base + 16));
+    }
+    assert(!frozen.has(static_cast<index_t>(first - 1)) && !frozen.has(std::numeric_limits<index_t>::max()));
+    if (std::is_signed_v<index_t>) assert(!frozen.has(std::numeric_limits<index_t>::min()));
+
+    uint64_t sum = 0, expected = 0, count = 0;
+    frozen.forEach([&sum, &count](uint64_t value, index_t) { sum += value; ++count; });
+    list.forEach([&expected](uint64_t value, index_t) { expected += value; });
+    assert(sum == expected && count == list.size());
+}
+
+void test26() {
+    // Test freeze and thaw
+    for (uint64_t blocks : { 0, 1, 7, 8, 9, 72, 73, 81, 650, 6000 }) {
+        checkFrozen<uint64_t>(blocks, 16);
+        checkFrozen<int64_t>(blocks, 48);
+        checkFrozen<uint32_t>(blocks, 32);
+    }
+
+    // unaligned blocks and extents keep their bases
+    BitmappedBlockSkipList<uint64_t, uint64_t, uint16_t, ExtentOptions> list(~0ULL);
+    for (uint64_t i = 0; i < 5000; ++i) list[i] = i;
+    for (uint64_t i = 0; i < 500; ++i) list[10000 + i * 11] = i;
+    list.compact();
+    assert(list.stats().extents > 0);
+
+    const auto& constList = list;
+    auto frozen = list.freeze();
+    for (uint64_t i = 0; i < 20000; ++i) assert(frozen.has(i) == list.has(i) && frozen[i] == constList[i]);
+
+    uint64_t sum = 0, expected = 0;
+    frozen.forEachInRange(4000, 12000, [&sum](uint64_t value, uint64_t) { sum += value; });
+    list.forEachInRange(4000, 12000, [&expected](uint64_t value, uint64_t) { expected += value; });
+    assert(sum == expected);
+    // a start far right of its floor block
+    sum = expected = 0;
+    frozen.forEachInRange(5251, 10100, [&sum](uint64_t value, uint64_t) { sum += value; });
+    list.forEachInRange(5251, 10100, [&expected](uint64_t value, uint64_t) { expected += value; });
+    assert(sum == expected);
+
+    // moved, then thawed into a list that takes writes again
+    auto moved = std::move(frozen);
+    assert(frozen.size() == 0 && !frozen.has(0) && moved.size() == list.size());
+    auto thawed = moved.thaw();
+    assert(thawed.size() == list.size());
+    for (uint64_t i = 0; i < 20000; ++i) assert(thawed.has(i) == list.has(i) && std::as_const(thawed)[i] == constList[i]);
+    thawed[3] = 33;
+    thawed.erase(4);
+    thawed[30000] = 1;
+    assert(thawed[3] == 33 && !thawed.has(4) && moved[3] == 3 && moved.has(4));
+
+    std::cout << "test26 passed!" << std::endl;
+}
+
+void test27() {
+    // Test copy-on-write snapshots
+    using SnapList = BitmappedBlockSkipList<uint64_t, uint64_t, uint16_t, SnapshotOptions>;
+    SnapList list(~0ULL);
+    for (uint64_t i = 0; i < 4000; ++i) list[i * 2] = i;
+    const size_t bytesBefore = list.stats().nodeBytes;
+
+    // taking a snapshot copies no block
+    auto snap = list.snapshot();
+    assert(snap.size() == 4000 && snap.blockSize() == list.stats().blocks);
+    assert(list.stats().nodeBytes == bytesBefore && list.stats().detached == 0);
+
+    // writes, erases and new blocks stay invisible to it
+    list[0] = 100;
+    list[2] = 101;
+    list.erase(4);
+    for (uint64_t i = 0; i < 16; ++i) list.erase(1600 + i);
+    list[100000] = 1;
+    auto it = list.lowerBound(5000);
+    it.setValue(7);
+    list.forEachBlock([](uint64_t base, uint16_t bitMap, uint64_t* elements) {
+        if (base == 6000 && (bitMap & 1)) elements[0] = 9;
+        });
+    list.compact();
+    assert(list[0] == 100 && list[2] == 101 && !list.has(4) && !list.has(1600) && list[5000] == 7 && list[6000] == 9);
+    for (uint64_t i = 0; i < 4000; ++i) assert(snap.has(i * 2) && snap[i * 2] == i && !snap.has(i * 2 + 1));
+    assert(!snap.has(100000) && snap[100000] == ~0ULL);
+    // forEachBlock copied every block the snapshot holds, the erased block left the list as it was
+    assert(list.stats().detached == snap.blockSize());
+
+    uint64_t sum = 0, count = 0;
+    snap.forEach([&](uint64_t value, uint64_t index) { sum += value; ++count; assert(index == value * 2); });
+    assert(count == 4000 && sum == 3999ULL * 4000 / 2);
+    sum = 0;
+    snap.forEachInRange(11, 21, [&sum](uint64_t value, uint64_t) { sum += value; });
+    assert(sum == 6 + 7 + 8 + 9 + 10);
+
+    // the snapshot writes the bytes the list had
+    std::ostringstream out(std::ios::binary);
+    assert(snap.serialize(out));
+    std::istringstream in(out.str(), std::ios::binary);
+    SnapList copy(~0ULL);
+    assert(copy.deserialize(in) && copy.size() == 4000 && copy[0] == 0 && copy[8] == 4 && !copy.has(100000));
+
+    // several snapshots, dropped in any order
+    auto second = list.snapshot();
+    list[0] = 200;
+    auto third = list.snapshot();
+    list[0] = 300;
+    assert(snap[0] == 0 && second[0] == 100 && third[0] == 200 && list[0] == 300);
+    {
+        auto dropped = std::move(second);
+        assert(second.size() == 0 && !second.has(0));
+    }
+    list[0] = 400;
+    assert(snap[0] == 0 && third[0] == 200);
+    third = std::move(snap);
+    assert(third[0] == 0 && third.size() == 4000);
+    third = SnapList::Snapshot(std::move(third));
+
+    // once the snapshots are gone the copied blocks are given back
+    { auto drop = std::move(third); }
+    for (uint64_t i = 0; i < 4000; ++i) list[i * 2] = i;
+    assert(list.stats().detached > 0);
+    { auto last = list.snapshot(); }
+    assert(list.stats().detached == 0);
+
+    // iterators into one shared block, the second one finds the copy the first one made
+    {
+        list[20000] = 9;
+        auto view = list.snapshot();
+        auto first = list.begin();
+        auto second = std::next(list.begin());
+        first.setValue(100);
+        second.setValue(200);
+        assert(list[0] == 100 && list[2] == 200 && view[0] == 0 && view[2] == 1);
+        // the block left the list with its last element, the write puts the key back
+        auto last = list.lowerBound(20000);
+        list.erase(20000);
+        assert(last.setValue(5) && list[20000] == 5 && view[20000] == 9);
+    }
+    list.erase(20000);
+
+    // a snapshot outlives clear, assign and the list itself
+    auto* owner = new SnapList(~0ULL);
+    for (uint64_t i = 0; i < 1000; ++i) (*owner)[i] = i;
+    auto beforeClear = owner->snapshot();
+    owner->clear();
+    (*owner)[5] = 55;
+    auto beforeDelete = owner->snapshot();
+    delete owner;
+    assert(beforeClear.size() == 1000 && beforeClear[999] == 999);
+    assert(beforeDelete.size() == 1 && beforeDelete[5] == 55 && !beforeDelete.has(6));
+
+    // a background reader scans and serializes while the list keeps changing
+    SnapList shared(~0ULL);
+    for (uint64_t i = 0; i < 50000; ++i) shared[i] = 1;
+    for (int round = 0; round < 4; ++round) {
+        auto view = shared.snapshot();
+        const uint64_t expected = view.size();
+        std::atomic<bool> ok{ true };
+        std::thread reader([&view, &ok, expected] {
+            for (int pass = 0; pass < 3; ++pass) {
+                uint64_t total = 0;
+                view.forEach([&total](uint64_t value, uint64_t) { total += value; });
+                std::ostringstream out(std::ios::binary);
+                if (total != expected || !view.serialize(out)) ok = false;
+            }
+            });
+        for (uint64_t i = 0; i < 50000; i += 3) shared[i] = 2;
+        for (uint64_t i = 1; i < 50000; i += 7) shared.erase(i);
+        for (uint64_t i = 0; i < 50000; i += 3) shared[i] = 1;
+        for (uint64_t i = 1; i < 50000; i += 7) shared[i] = 1;
+        reader.join();
+        assert(ok);
+    }
+    assert(shared.size() == 50000);
+
+    std::cout << "test27 passed!" << std::endl;
+}
+
+void test28() {
+    // Test standard iterators
+    using List = BitmappedBlockSkipList<uint64_t, int>;
+    static_assert(std::is_same_v<std::iterator_traits<List::iterator>::iterator_category, std::bidirectional_iterator_tag>);
+    static_assert(std::is_same_v<std::iterator_traits<List::const_iterator>::reference, const int&>);
+    static_assert(std::is_convertible_v<List::iterator, List::const_iterator> && !std::is_convertible_v<List::const_iterator, List::iterator>);
+
+    List empty(-1);
+    assert(empty.begin() == empty.end() && empty.rbegin() == empty.rend() && std::as_const(empty).cbegin() == empty.cend());
+
+    List list(-1);
+    std::map<uint64_t, int> expected;
+    for (uint64_t i = 0; i < 3000; ++i) {
+        list[i * 7] = static_cast<int>(i);
+        expected[i * 7] = static_cast<int>(i);
+    }
+
+    // <algorithm> and range-for over a const list
+    const List& constList = list;
+    int64_t sum = 0;
+    for (const int& value : constList) sum += value;
+    assert(sum == std::accumulate(constList.begin(), constList.end(), int64_t(0)));
+    assert(std::distance(constList.begin(), constList.end()) == 3000);
+    assert(std::count_if(list.begin(), list.end(), [](int value) { return value % 2 == 0; }) == 1500);
+    auto found = std::find(list.cbegin(), list.cend(), 1234);
+    assert(found != list.cend() && found.key() == 1234 * 7);
+
+    // a real reverse adaptor
+    std::vector<int> backwards(list.rbegin(), list.rend());
+    assert(backwards.size() == 3000 && backwards.front() == 2999 && backwards.back() == 0);
+    assert(std::is_sorted(backwards.rbegin(), backwards.rend()));
+    auto rit = expected.rbegin();
+    for (auto it = constList.crbegin(); it != constList.crend(); ++it, ++rit) assert(*it == rit->second);
+
+    // end() steps back to the last element, post increment and decrement
+    auto last = std::prev(list.end());
+    assert(last.key() == 2999 * 7 && *last == 2999);
+    auto first = list.begin();
+    assert((first++).key() == 0 && first.key() == 7 && (first--).key() == 7 && first == list.begin());
+    assert(!list.end() && list.begin() && list.end().key() == 0);
+
+    // writes through the mutable iterator and the key/value proxy
+    std::fill(list.lowerBound(700), list.lowerBound(1400), 5);
+    for (auto it = constList.lowerBound(700); it != constList.lowerBound(1400); ++it) assert(*it == 5);
+    auto entry = list.lowerBound(3).entry();
+    assert(entry.key == 7 && entry.value == 1);
+    entry.value = 70;
+    assert(constList[7] == 70);
+    List::const_iterator converted = list.begin();
+    assert(converted == constList.begin() && converted.entry().key == 0);
+
+    // a mutable iterator copies a block shared with a snapshot before it writes
+    BitmappedBlockSkipList<uint64_t, int, uint16_t, SnapshotOptions> shared(-1);
+    for (uint64_t i = 0; i < 100; ++i) shared[i] = 1;
+    auto snap = shared.snapshot();
+    for (int& value : shared) value = 2;
+    assert(std::accumulate(shared.cbegin(), shared.cend(), 0) == 200);
+    int snapSum = 0;
+    snap.forEach([&snapSum](int value, uint64_t) { snapSum += value; });
+    assert(snapSum == 100);
+
+    // an algorithm with several iterators in one shared block, every one of them ends up on the same copy
+    BitmappedBlockSkipList<uint64_t, int, uint16_t, SnapshotOptions> reversed(-1);
+    for (uint64_t i = 0; i < 1000; ++i) reversed[i * 3] = static_cast<int>(i);
+    auto before = reversed.snapshot();
+    std::reverse(reversed.begin(), reversed.end());
+    uint64_t position = 0;
+    for (auto it = reversed.cbegin(); it != reversed.cend(); ++it, ++position) {
+        assert(it.key() == position * 3 && *it == 999 - static_cast<int>(position));
+    }
+    assert(position == 1000 && std::is_sorted(reversed.rbegin(), reversed.rend()));
+    before.forEach([](int value, uint64_t index) { assert(index == static_cast<uint64_t>(value) * 3); });
+
+    // reads through a const_iterator leave the blocks shared
+    auto again = reversed.snapshot();
+    const uint64_t detached = reversed.stats().detached;
+    assert(std::accumulate(reversed.cbegin(), reversed.cend(), 0) == 999 * 1000 / 2 && reversed.stats().detached == detached);
+
+    std::cout << "test28 passed!" << std::endl;
+}
+
+// counts the workers it was asked to run, on the calling thread
+struct CountingExecutor {
+    mutable uint32_t workers = 0;
+
+    uint32_t concurrency() const {
+        return 3;
+    }
+
+    template<typename Job>
+    void run(const uint32_t workers, Job& job) const {
+        this->workers = workers;
+        for (uint32_t w = 0; w < workers; ++w) job(w);
+    }
+};
+
+void test29() {
+    // Test parallel traversal and reduction
+    BitmappedBlockSkipList<uint64_t, uint64_t> empty(0);
+    assert(empty.parallelReduce(uint64_t(0), [](uint64_t a, uint64_t b) { return a + b; }) == 0);
+    assert(!empty.parallelSome([](uint64_t, uint64_t) { return true; }) && empty.parallelEvery([](uint64_t, uint64_t) { return false; }));
+
+    for (uint64_t n : { uint64_t(1), uint64_t(100), uint64_t(200000) }) {
+        BitmappedBlockSkipList<uint64_t, uint64_t> list(0);
+        for (uint64_t i = 0; i < n; ++i) list[i * 3] = i;
+        const uint64_t expected = list.sum<uint64_t>();
+
+        const bbsl::ThreadExecutor four{ 4 };
+        std::atomic<uint64_t> sum{ 0 }, visits{ 0 }, keys{ 0 };
+        list.parallelForEach([&](uint64_t value, uint64_t index) {
+            sum.fetch_add(value, std::memory_order_relaxed);
+            keys.fetch_add(index, std::memory_order_relaxed);
+            visits.fetch_add(1, std::memory_order_relaxed);
+            }, four);
+        assert(sum == expected && keys == expected * 3 && visits == n);
+
+        auto add = [](uint64_t a, uint64_t b) { return a + b; };
+        assert(list.parallelReduce(uint64_t(0), add) == expected);
+        assert(list.parallelReduce(uint64_t(0), add, four) == expected);
+        assert(list.parallelReduce(uint64_t(0), add, bbsl::InlineExecutor()) == expected);
+        assert(list.parallelReduce(uint64_t(0), [](uint64_t a, uint64_t b) { return std::max(a, b); }, four) == n - 1);
+
+        CountingExecutor counting;
+        assert(list.parallelReduce(uint64_t(0), add, counting) == expected);
+        assert(counting.workers >= 1 && counting.workers <= 3);
+
+        assert(list.parallelSome([n](uint64_t value, uint64_t) { return value == n - 1; }, four));
+        assert(!list.parallelSome([](uint64_t value, uint64_t) { return value == ~0ULL; }, four));
+        assert(list.parallelEvery([](uint64_t value, uint64_t index) { return index == value * 3; }, four));
+        assert(!list.parallelEvery([n](uint64_t value, uint64_t) { return value + 1 < n; }, four));
+    }
+
+    // a hit cancels the other runs
+    BitmappedBlockSkipList<uint64_t, uint64_t> big(0);
+    for (uint64_t i = 0; i < 1000000; ++i) big[i] = i;
+    std::atomic<uint64_t> visited{ 0 };
+    assert(big.parallelSome([&visited](uint64_t, uint64_t) { visited.fetch_add(1, std::memory_order_relaxed); return true; }, bbsl::InlineExecutor()));
+    assert(visited == 1);
+    visited = 0;
+    assert(big.parallelSome([&visited](uint64_t value, uint64_t) { visited.fetch_add(1, std::memory_order_relaxed); return value == 500000; }, bbsl::ThreadExecutor{ 4 }));
+    assert(visited < 1000000);
+
+    // a throwing worker is joined with the others and its exception reaches the caller
+    for (int round = 0; round < 2; ++round) {
+        bool caught = false;
+        try {
+            big.parallelForEach([](uint64_t value, uint64_t) { if (value == 700000) throw std::runtime_error("worker"); }, bbsl::ThreadExecutor{ 4 });
+        }
+        catch (const std::runtime_error&) {
+            caught = true;
+        }
+        assert(caught);
+    }
+    bool caught = false;
+    try {
+        big.parallelReduce(uint64_t(0), [](uint64_t acc, uint64_t value) { if (value == 3) throw std::runtime_error("run 0"); return acc + value; }, bbsl::ThreadExecutor{ 4 });
+    }
+    catch (const std::runtime_error&) {
+        caught = true;
+    }
+    assert(caught);
+
+    std::cout << "test29 passed!" << std::endl;
+}
+
+template <typename Options>
+void checkShift(uint64_t seed) {
+    BitmappedBlockSkipList<int64_t, int64_t, uint16_t, Options> list(-1);
+    std::map<int64_t, int64_t> expected;
+    std::mt19937_64 rng(seed);
+    for (int i = 0; i < 3000; ++i) {
+        const int64_t key = static_cast<int64_t>(rng() % 8000) - 2000;
+        list[key] = key;
+        expected[key] = key;
+    }
+    for (int64_t key = 100; key < 1500; ++key) {
+        list[key] = key;
+        expected[key] = key;
+    }
+    if constexpr (Options::extent_blocks != 0) {
+        list.compact();
+        assert(list.stats().extents > 0);
+    }
+
+    for (int round = 0; round < 200; ++round) {
+        const int64_t from = static_cast<int64_t>(rng() % 10000) - 3000;
+        int64_t delta = static_cast<int64_t>(rng() % 100) - 50;
+        if (round % 5 == 0) delta *= 17;
+
+        std::map<int64_t, int64_t> next;
+        for (const auto& [key, value] : expected) {
+            if (key < from) {
+                if (delta >= 0 || key < from + delta) next[key] = value;
+            }
+            else {
+                next[key + delta] = value;
+            }
+        }
+        expected.swap(next);
+        list.shiftIndices(from, delta);
+
+        if (round % 10 == 0 || round == 199) {
+            assert(list.size() == expected.size());
+            auto it = expected.begin();
+            list.forEach([&it](int64_t value, int64_t index) {
+                assert(index == it->first && value == it->second);
+                ++it;
+                });
+            assert(it == expected.end());
+            for (int k = 0; k < 200; ++k) {
+                const int64_t key = static_cast<int64_t>(rng() % 12000) - 4000;
+                auto found = expected.find(key);
+                assert(std::as_const(list)[key] == ((found != expected.end()) ? found->second : -1));
+            }
+        }
+        // writes land where the model expects them
+        const int64_t key = static_cast<int64_t>(rng() % 8000) - 2000;
+        list[key] = round;
+        expected[key] = round;
+    }
+    assert(std::equal(list.cbegin(), list.cend(), expected.begin(), expected.end(),
+        [](int64_t value, const std::pair<const int64_t, int64_t>& entry) { return value == entry.second; }));
+}
+
+void test30() {
+    // Test index shifting
+    checkShift<DefaultOptions>(30);
+    checkShift<IndexCacheOptions>(31);
+    checkShift<ExtentOptions>(32);
+    checkShift<SnapshotOptions>(33);
+
+    // eraseRange masks whole blocks
+    BitmappedBlockSkipList<uint64_t, uint64_t> list(~0ULL);
+    for (uint64_t i = 0; i < 1000; ++i) list[i] = i;
+    assert(list.eraseRange(10, 990) == 980 && list.size() == 20 && list.stats().blocks == 3);
+    assert(list.eraseRange(5, 5) == 0 && list.eraseRange(2000, 3000) == 0);
+    assert(list.has(9) && !list.has(10) && list.has(990));
+
+    // shift in a loop, the array of an interpreter
+    BitmappedBlockSkipList<uint64_t, uint64_t> array(~0ULL);
+    for (uint64_t i = 0; i < 5000; ++i) array[i] = i;
+    for (uint64_t i = 0; i < 4990; ++i) {
+        assert(array[0] == i);
+        array.shiftIndices(1, -1);
+    }
+    assert(array.size() == 10 && std::as_const(array)[9] == 4999 && !array.has(10));
+    // unshift moves the blocks as a whole
+    const uint64_t blocks = array.stats().blocks;
+    assert(array.shiftIndices(0, 32) == blocks);
+    assert(!array.has(0) && array[32] == 4990 && array.stats().blocks == blocks);
+
+    // a snapshot keeps the old numbering
+    BitmappedBlockSkipList<uint64_t, uint64_t, uint16_t, SnapshotOptions> shared(~0ULL);
+    for (uint64_t i = 0; i < 100; ++i) shared[i] = i;
+    auto snap = shared.snapshot();
+    shared.shiftIndices(50, 7);
+    assert(shared[57] == 50 && !shared.has(50) && snap[50] == 50 && !snap.has(106) && std::as_const(shared)[106] == 99);
+
+    std::cout << "test30 passed!" << std::endl;
+}
+
+struct SnapshotOrderOptions : bbsl::DefaultOptions {
+    static constexpr bool snapshots = true;
+    static constexpr bool order_statistics = true;
+};
+
+struct IndexedOrderOptions : bbsl::DefaultOptions {
+    static constexpr uint16_t index_cache_slots = 64;
+    static constexpr bool indexed_levels = true;
+    static constexpr bool order_statistics = true;
+};
+
+template<typename List>
+void checkOrder(const List& list, const std::map<int64_t, int64_t>& expected, std::mt19937_64& rng) {
+    assert(list.size() == expected.size());
+    std::vector<int64_t> keys;
+    for (const auto& entry : expected) keys.push_back(entry.first);
+
+    for (uint64_t k = 0; k < keys.size(); ++k) {
+        auto it = list.nth(k);
+        assert(it != list.end() && it.key() == keys[k] && *it == expected.at(keys[k]));
+    }
+    assert(list.nth(keys.size()) == list.end());
+
+    for (int s = 0; s < 300; ++s) {
+        const int64_t key = static_cast<int64_t>(rng() % 12000) - 4000;
+        const uint64_t before = static_cast<uint64_t>(std::lower_bound(keys.begin(), keys.end(), key) - keys.begin());
+        assert(list.rank(key) == before);
+    }
+    if (!keys.empty()) assert(list.rank(keys.back()) == keys.size() - 1);
+}
+
+template<typename Options>
+void checkOrderStatistics(uint64_t seed) {
+    BitmappedBlockSkipList<int64_t, int64_t, uint16_t, Options> list(-1);
+    std::map<int64_t, int64_t> expected;
+    std::mt19937_64 rng(seed);
+
+    for (int round = 0; round < 60; ++round) {
+        for (int i = 0; i < 200; ++i) {
+            const int64_t key = static_cast<int64_t>(rng() % 8000) - 2000;
+            if (rng() % 3 == 0) {
+                list.erase(key);
+                expected.erase(key);
+            }
+            else {
+                list[key] = key;
+                expected[key] = key;
+            }
+        }
+
+        switch (round % 6) {
+        case 0: {
+            const int64_t start = static_cast<int64_t>(rng() % 8000) - 2000;
+            const int64_t end = start + static_cast<int64_t>(rng() % 500);
+            list.eraseRange(start, end);
+            expected.erase(expected.lower_bound(start), expected.lower_bound(end));
+            break;
+        }
+        case 1: {
+            const int64_t from = static_cast<int64_t>(rng() % 8000) - 2000;
+            const int64_t delta = static_cast<int64_t>(rng() % 100) - 50;
+            std::map<int64_t, int64_t> next;
+            for (const auto& [key, value] : expected) {
+                if (key >= from) next[key + delta] = value;
+                else if (delta >= 0 || key < from + delta) next[key] = value;
+            }
+            expected.swap(next);
+            list.shiftIndices(from, delta);
+            break;
+        }
+        case 2: {
+            std::vector<int64_t> keys, values;
+            for (int i = 0; i < 300; ++i) keys.push_back(static_cast<int64_t>(rng() % 8000) - 2000);
+            std::sort(keys.begin(), keys.end());
+            for (const int64_t key : keys) {
+                values.push_back(-key);
+                expected[key] = -key;
+            }
+            list.setMany(keys.data(), values.data(), keys.size());
+            break;
+        }
+        case 3:
+            list.compact();
+            break;
+        case 4: {
+            // rebuilt towers get recounted links
+            if (round == 22) {
+                list.assign(expected.begin(), expected.end());
+            }
+            else {
+                decltype(list) other(-1);
+                other.assign(expected.begin(), expected.end());
+                list.swap(other);
+            }
+            break;
+        }
+        default: {
+            auto it = list.begin();
+            for (int i = 0; i < 50 && it != list.end(); ++i) ++it;
+            if (it != list.end()) {
+                it.setValue(7);
+                expected[it.key()] = 7;
+            }
+            break;
+        }
+        }
+
+        if constexpr (Options::snapshots) {
+            // writes under a live snapshot copy blocks, the counts follow the copies
+            auto snap = list.snapshot();
+            for (int i = 0; i < 50; ++i) {
+                const int64_t key = static_cast<int64_t>(rng() % 8000) - 2000;
+                list[key] = 1;
+                expected[key] = 1;
+            }
+            checkOrder(list, expected, rng);
+        }
+        else if (round % 5 == 0) {
+            checkOrder(list, expected, rng);
+        }
+    }
+    checkOrder(list, expected, rng);
+
+    // paging by position
+    std::vector<int64_t> page;
+    for (auto it = std::as_const(list).nth(list.size() / 2); it != list.cend() && page.size() < 10; ++it) page.push_back(it.key());
+    auto entry = std::next(expected.begin(), static_cast<int64_t>(expected.size() / 2));
+    for (const int64_t key : page) assert(key == (entry++)->first);
+
+    while (list.size() != 0) list.erase(list.nth(0).key());
+    assert(list.rank(0) == 0 && list.nth(0) == list.end());
+}
+
+void test31() {
+    // Test order statistics
+    checkOrderStatistics<OrderStatisticOptions>(310);
+    checkOrderStatistics<SnapshotOrderOptions>(311);
+    checkOrderStatistics<IndexedOrderOptions>(312);
+    // without the option the same queries walk level 0
+    checkOrderStatistics<DefaultOptions>(313);
+
+    BitmappedBlockSkipList<uint64_t, uint64_t, uint16_t, OrderStatisticOptions> list(~0ULL);
+    for (uint64_t i = 0; i < 100000; ++i) list[i * 3] = i;
+    assert(list.rank(0) == 0 && list.rank(1) == 1 && list.rank(3 * 99999) == 99999 && list.rank(~0ULL) == 100000);
+    assert(*list.nth(4242) == 4242 && list.nth(99999).key() == 3 * 99999);
+    *list.nth(10) = 5;
+    assert(list[30] == 5);
+
+    std::cout << "test31 passed!" << std::endl;
+}
+
+template<typename Options>
+void checkSetAlgebra(uint64_t seed) {
+    using List = BitmappedBlockSkipList<int64_t, int64_t, uint16_t, Options>;
+    std::mt19937_64 rng(seed);
+
+    for (int round = 0; round < 40; ++round) {
+        List a(-1), b(-1);
+        std::map<int64_t, int64_t> ma, mb;
+        const int64_t range = (round % 2 == 0) ? 600 : 6000;
+        for (int i = 0; i < 800; ++i) {
+            const int64_t key = static_cast<int64_t>(rng() % range) - 100;
+            if (rng() % 2 == 0) {
+                a[key] = key;
+                ma[key] = key;
+            }
+            else {
+                b[key] = 2 * key;
+                mb[key] = 2 * key;
+            }
+        }
+        // odd shifts leave unaligned bases, so the windows of a and b overlap
+        if (round % 4 == 1) {
+            a.shiftIndices(13, 7);
+            std::map<int64_t, int64_t> next;
+            for (const auto& [key, value] : ma) next[(key >= 13) ? key + 7 : key] = value;
+            ma.swap(next);
+        }
+        if (round % 4 == 3) {
+            b.shiftIndices(-50, 3);
+            std::map<int64_t, int64_t> next;
+            for (const auto& [key, value] : mb) next[(key >= -50) ? key + 3 : key] = value;
+            mb.swap(next);
+        }
+
+        auto verify = [](const List& list, const std::map<int64_t, int64_t>& expected) {
+            assert(list.size() == expected.size());
+            assert(std::equal(list.cbegin(), list.cend(), expected.begin(), expected.end(),
+                [](int64_t value, const std::pair<const int64_t, int64_t>& entry) { return value == entry.second; }));
+            for (const auto& [key, value] : expected) assert(std::as_const(list)[key] == value);
+        };
+
+        List u(a), i(a), d(a);
+        std::map<int64_t, int64_t> mu = ma, mi, md;
+        uint64_t added = 0;
+        for (const auto& [key, value] : mb) {
+            auto found = mu.find(key);
+            if (found != mu.end()) found->second = found->second * 10 + value;
+            else {
+                mu[key] = value;
+                ++added;
+            }
+        }
+        for (const auto& [key, value] : ma) {
+            if (mb.count(key) != 0) mi[key] = value;
+            else md[key] = value;
+        }
+
+        assert(u.unionWith(b, [](int64_t mine, int64_t theirs) { return mine * 10 + theirs; }) == added);
+        verify(u, mu);
+        assert(i.intersectKeys(b) == ma.size() - mi.size());
+        verify(i, mi);
+        assert(d.subtract(b) == ma.size() - md.size());
+        verify(d, md);
+    }
+
+    // with itself
+    List list(-1);
+    for (int64_t k = 0; k < 500; k += 3) list[k] = k;
+    assert(list.intersectKeys(list) == 0 && list.size() == 167);
+    assert(list.unionWith(list, [](int64_t mine, int64_t theirs) { return mine + theirs; }) == 0 && list[300] == 600);
+    assert(list.subtract(list) == 167 && list.size() == 0);
+}
+
+void test32() {
+    // Test set algebra
+    checkSetAlgebra<DefaultOptions>(320);
+    checkSetAlgebra<IndexCacheOptions>(321);
+    checkSetAlgebra<OrderStatisticOptions>(322);
+    checkSetAlgebra<SnapshotOrderOptions>(323);
+
+    // aligned blocks are merged word by word, the nodes of the right list are copied whole into gaps
+    BitmappedBlockSkipList<uint64_t, uint64_t, uint16_t, OrderStatisticOptions> evens(~0ULL), odds(~0ULL);
+    for (uint64_t k = 0; k < 10000; ++k) ((k % 2 == 0) ? evens : odds)[k] = k;
+    for (uint64_t k = 20000; k < 20100; ++k) odds[k] = k;
+    const uint64_t blocks = evens.stats().blocks;
+    assert(evens.unionWith(odds, [](uint64_t mine, uint64_t) { return mine; }) == 5100);
+    assert(evens.size() == 10100 && evens.stats().blocks == blocks + odds.stats().blocks - 625);
+    assert(evens.rank(20000) == 10000 && *evens.nth(9999) == 9999);
+    assert(evens.subtract(odds) == 5100 && evens.size() == 5000 && !evens.has(1) && evens.has(2));
+    assert(evens.intersectKeys(odds) == 5000 && evens.size() == 0);
+
+    // on an unaligned list the right block may start inside the window of a block with the same base
+    BitmappedBlockSkipList<int64_t, int64_t> moved(-1), small(-1);
+    moved[0] = 1;
+    for (int64_t k = 16; k < 32; ++k) moved[k] = k;
+    moved.shiftIndices(16, -11);
+    small[0] = 2;
+    small[7] = 999;
+    assert(moved.unionWith(small, [](int64_t mine, int64_t theirs) { return mine + theirs; }) == 0);
+    assert(moved.size() == 17 && moved[0] == 3 && moved[7] == 1017 && moved[20] == 31);
+    int64_t seen = 0, last = -1;
+    moved.forEach([&seen, &last](int64_t, int64_t index) { assert(index > last); last = index; ++seen; });
+    assert(seen == 17);
+
+    // a snapshot keeps the blocks a set operation rewrites
+    BitmappedBlockSkipList<uint64_t, uint64_t, uint16_t, SnapshotOptions> shared(~0ULL), other(~0ULL);
+    for (uint64_t k = 0; k < 1000; ++k) shared[k] = k;
+    for (uint64_t k = 0; k < 1000; k += 2) other[k] = k;
+    auto snap = shared.snapshot();
+    assert(shared.subtract(other) == 500 && snap.size() == 1000 && snap[10] == 10 && !shared.has(10));
+
+    std::cout << "test32 passed!" << std::endl;
+}
+
+struct Tracked {
+    static int64_t live;
+    std::string text;
+
+    Tracked() : text("-") { ++live; }
+    Tracked(const std::string& text) : text(text) { ++live; }
+    Tracked(const char* prefix, int64_t key) : text(std::string(prefix) + std::to_string(key) + " and a tail past the small string buffer") { ++live; }
+    Tracked(const Tracked& other) : text(other.text) { ++live; }
+    Tracked(Tracked&& other) noexcept : text(std::move(other.text)) { ++live; }
+    Tracked& operator=(const Tracked&) = default;
+    Tracked& operator=(Tracked&&) noexcept = default;
+    ~Tracked() { --live; }
+};
+int64_t Tracked::live = 0;
+
+// throws from its constructors while fail is set
+struct Fragile {
+    static bool fail;
+    int value;
+
+    Fragile(int value) : value(value) { if (fail) throw std::runtime_error("construct"); }
+    Fragile(const Fragile& other) : value(other.value) { if (fail) throw std::runtime_error("copy"); }
+    Fragile& operator=(const Fragile&) = default;
+};
+bool Fragile::fail = false;
+
+template<typename Options>
+void checkLifetime(uint64_t seed) {
+    using List = BitmappedBlockSkipList<int64_t, Tracked, uint16_t, Options>;
+    std::mt19937_64 rng(seed);
+    {
+        List list(Tracked("invalid"));
+        std::map<int64_t, std::string> expected;
+        auto verify = [&]() {
+            assert(list.size() == expected.size());
+            auto it = expected.begin();
+            for (const Tracked& value : std::as_const(list)) {
+                assert(value.text == it->second);
+                ++it;
+            }
+            // the list holds one object per element plus the invalid value
+            assert(Tracked::live == static_cast<int64_t>(list.size()) + 1);
+        };
+
+        for (int round = 0; round < 30; ++round) {
+            for (int i = 0; i < 300; ++i) {
+                const int64_t key = static_cast<int64_t>(rng() % 5000) - 1000;
+                switch (rng() % 4) {
+                case 0:
+                    list[key] = Tracked("set ", key);
+                    expected[key] = Tracked("set ", key).text;
+                    break;
+                case 1:
+                    list.emplace(key, "emplaced ", key);
+                    expected[key] = Tracked("emplaced ", key).text;
+                    break;
+                case 2:
+                    list.erase(key);
+                    expected.erase(key);
+                    break;
+                default:
+                    assert(std::as_const(list)[key].text == ((expected.count(key) != 0) ? expected[key] : std::string("invalid")));
+                    break;
+                }
+            }
+            verify();
+
+            switch (round % 5) {
+            case 0: {
+                const int64_t start = static_cast<int64_t>(rng() % 5000) - 1000;
+                list.eraseRange(start, start + 300);
+                expected.erase(expected.lower_bound(start), expected.lower_bound(start + 300));
+                break;
+            }
+            case 1: {
+                const int64_t from = static_cast<int64_t>(rng() % 5000) - 1000;
+                const int64_t delta = static_cast<int64_t>(rng() % 60) - 30;
+                std::map<int64_t, std::string> next;
+                for (const auto& [key, text] : expected) {
+                    if (key >= from) next[key + delta] = text;
+                    else if (delta >= 0 || key < from + delta) next[key] = text;
+                }
+                expected.swap(next);
+                list.shiftIndices(from, delta);
+                break;
+            }
+            case 2:
+                list.compact();
+                if constexpr (Options::extent_blocks != 0) {
+                    for (int64_t key = 6000; key < 6256; ++key) {
+                        list.emplace(key, "dense ", key);
+                        expected[key] = Tracked("dense ", key).text;
+                    }
+                    list.promoteExtents(2);
+                }
+                break;
+            case 3: {
+                // copies own their values, a moved-from list owns nothing
+                List copy(list);
+                List moved(std::move(copy));
+                assert(copy.size() == 0 && moved.size() == list.size());
+                List other(Tracked("other"));
+                std::map<int64_t, std::string> theirs;
+                for (int i = 0; i < 200; ++i) {
+                    const int64_t key = static_cast<int64_t>(rng() % 5000) - 1000;
+                    other.emplace(key, "theirs ", key);
+                    theirs[key] = Tracked("theirs ", key).text;
+                }
+                list.unionWith(other, [](const Tracked& mine, const Tracked&) { return mine; });
+                for (const auto& entry : theirs) expected.insert(entry);
+                moved.subtract(other);
+                list.intersectKeys(moved);
+                for (const auto& entry : theirs) expected.erase(entry.first);
+                break;
+            }
+            default: {
+                std::vector<int64_t> keys;
+                std::vector<Tracked> values;
+                for (int i = 0; i < 100; ++i) keys.push_back(static_cast<int64_t>(rng() % 5000) - 1000);
+                std::sort(keys.begin(), keys.end());
+                keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+                for (const int64_t key : keys) {
+                    values.emplace_back("many ", key);
+                    expected[key] = values.back().text;
+                }
+                list.setMany(keys.data(), values.data(), keys.size());
+                values.clear();
+                list.eraseMany(keys.data(), keys.size() / 2);
+                for (size_t k = 0; k < keys.size() / 2; ++k) expected.erase(keys[k]);
+                break;
+            }
+            }
+            verify();
+        }
+
+        List assigned(Tracked("assigned"));
+        assigned.assign(expected.begin(), expected.end());
+        list.swap(assigned);
+        assert(list.size() == assigned.size() && Tracked::live == static_cast<int64_t>(2 * expected.size()) + 2);
+        assigned.clear();
+        assert(assigned.size() == 0 && Tracked::live == static_cast<int64_t>(expected.size()) + 2);
+    }
+    assert(Tracked::live == 0);
+}
+
+void test33() {
+    // Test values with a lifetime
+    static_assert(!BitmappedBlockSkipList<int, Tracked>::trivial_values && BitmappedBlockSkipList<int, int>::trivial_values);
+    checkLifetime<DefaultOptions>(330);
+    checkLifetime<ExtentOptions>(331);
+    checkLifetime<OrderStatisticOptions>(332);
+    checkLifetime<IndexCacheOptions>(333);
+
+    // refcounted values are released on erase and clear
+    auto shared = std::make_shared<int>(7);
+    {
+        BitmappedBlockSkipList<uint64_t, std::shared_ptr<int>> list(nullptr);
+        for (uint64_t i = 0; i < 1000; ++i) list[i] = shared;
+        assert(shared.use_count() == 1001);
+        list.eraseRange(0, 500);
+        assert(shared.use_count() == 501);
+        list.emplace(2000, shared);
+        list.erase(999);
+        assert(shared.use_count() == 501 && *list[2000] == 7);
+        list.shiftIndices(600, 10);
+        assert(shared.use_count() == 501 && list[610] == shared && list[599] == shared && !list.has(600));
+    }
+    assert(shared.use_count() == 1);
+
+    // move-only writes move instead of copy
+    BitmappedBlockSkipList<uint64_t, std::string> names("");
+    std::string name(100, 'x');
+    names[5] = std::move(name);
+    assert(name.empty() && names[5].size() == 100 && (*names.nth(0)).size() == 100);
+
+    // a constructor that throws into a new block leaves no empty block behind
+    BitmappedBlockSkipList<uint64_t, Fragile> fragile(Fragile(-1));
+    fragile[0] = Fragile(1);
+    Fragile::fail = true;
+    for (int attempt = 0; attempt < 3; ++attempt) {
+        bool thrown = false;
+        try {
+            if (attempt == 0) fragile.emplace(1000, 5);
+            else if (attempt == 1) fragile[2000];
+            else {
+                const uint64_t key = 3000;
+                fragile.setMany(&key, &fragile[0], 1);
+            }
+        }
+        catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown && fragile.size() == 1 && fragile.stats().blocks == 1);
+    }
+    Fragile::fail = false;
+    assert(!fragile.has(1000) && !fragile.has(2000) && fragile[0].value == 1);
+
+    std::cout << "test33 passed!" << std::endl;
+}
+
 // ============= Original Performance Tests =============
 
 void test_performance_stdmap(uint64_t seed) {
@@ -380,9 +2493,10 @@ void test_performance_zipf_stdmap(uint64_t seed) {
         << (end_mixed - start_mixed).count() / 1e9 << "s\n";
 }
 
-void test_performance_zipf_bsl(uint64_t seed) {
+template<typename Options = bbsl::DefaultOptions>
+void test_performance_zipf_bsl(uint64_t seed, const char* tag = "bsl") {
     const uint64_t N = testCount;
-    BitmappedBlockSkipList<uint64_t, int> skiplist(-1);
+    BitmappedBlockSkipList<uint64_t, int, uint16_t, Options> skiplist(-1);
     ZipfGenerator zipf(seed, N, 0.8);
 
     // Pre-insert all data
@@ -398,10 +2512,10 @@ void test_performance_zipf_bsl(uint64_t seed) {
         sum += skiplist[idx];
     }
     auto end_query = std::chrono::high_resolution_clock::now();
-    std::cout << "[bsl] Zipf Query (α=0.8) " << N << " : "
+    std::cout << "[" << tag << "] Zipf Query (α=0.8) " << N << " : "
         << (end_query - start_query).count() / 1e9 << "s\n";
-    std::cout << "[bsl] Sum: " << sum << std::endl;
-    std::cout << "[bsl] level " << skiplist.getLevel() << std::endl;
+    std::cout << "[" << tag << "] Sum: " << sum << std::endl;
+    std::cout << "[" << tag << "] level " << skiplist.getLevel() << std::endl;
 
     // Zipf distribution mixed operations (80% query, 20% update)
     ZipfGenerator zipf2(seed + 1, N, 0.8);
@@ -416,7 +2530,7 @@ void test_performance_zipf_bsl(uint64_t seed) {
         }
     }
     auto end_mixed = std::chrono::high_resolution_clock::now();
-    std::cout << "[bsl] Zipf Mixed (80/20) " << N << " : "
+    std::cout << "[" << tag << "] Zipf Mixed (80/20) " << N << " : "
         << (end_mixed - start_mixed).count() / 1e9 << "s\n";
 }
 
@@ -468,6 +2582,22 @@ void test_performance_range_bsl() {
     std::cout << "[bsl] Range queries (500 elements x 1000) : "
         << (end_range - start_range).count() / 1e9 << "s\n";
     std::cout << "[bsl] Range sum: " << sum << std::endl;
+
+    start_range = std::chrono::high_resolution_clock::now();
+    int sum2 = 0;
+    for (uint64_t i = 0; i < 1000; ++i) {
+        uint64_t start = i * 1000;
+        uint64_t end = start + 500;
+        skiplist.forEachInRange(start, end, [&sum2](int value, uint64_t) {
+            sum2 += value;
+            });
+    }
+    end_range = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl] forEachInRange (500 elements x 1000) : "
+        << (end_range - start_range).count() / 1e9 << "s\n";
+    std::cout << "[bsl] forEachInRange sum: " << sum2 << std::endl;
+
+    assert(sum == sum2);
 }
 
 // ============= New: Batch Operation Performance Tests =============
@@ -486,6 +2616,12 @@ void test_performance_batch_stdmap() {
     auto end_batch = std::chrono::high_resolution_clock::now();
     std::cout << "[std::map] Batch insert (1000/batch) : "
         << (end_batch - start_batch).count() / 1e9 << "s\n";
+
+    auto start_clear = std::chrono::high_resolution_clock::now();
+    m.clear();
+    auto end_clear = std::chrono::high_resolution_clock::now();
+    std::cout << "[std::map] Teardown " << N << " : "
+        << (end_clear - start_clear).count() / 1e9 << "s\n";
 }
 
 void test_performance_batch_bsl() {
@@ -502,6 +2638,49 @@ void test_performance_batch_bsl() {
     auto end_batch = std::chrono::high_resolution_clock::now();
     std::cout << "[bsl] Batch insert (1000/batch) : "
         << (end_batch - start_batch).count() / 1e9 << "s\n";
+
+    auto start_clear = std::chrono::high_resolution_clock::now();
+    skiplist.clear();
+    auto end_clear = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl] Teardown " << N << " : "
+        << (end_clear - start_clear).count() / 1e9 << "s\n";
+
+    std::vector<int> values(N);
+    for (uint64_t i = 0; i < N; ++i) values[i] = static_cast<int>(i);
+    BitmappedBlockSkipList<uint64_t, int> bulk(-1);
+
+    auto start_bulk = std::chrono::high_resolution_clock::now();
+    bulk.assign(0, values.begin(), values.end());
+    auto end_bulk = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl] Bulk assign " << N << " : "
+        << (end_bulk - start_bulk).count() / 1e9 << "s\n";
+
+    // Sorted random keys, one descent per key vs finger search
+    std::vector<uint64_t> keys(N);
+    uint64_t seed = 99;
+    for (uint64_t i = 0; i < N; ++i) {
+        seed = seed * 6364136223846793005ULL + 1;
+        keys[i] = (seed >> 17) % N;
+    }
+    std::sort(keys.begin(), keys.end());
+
+    auto start_single = std::chrono::high_resolution_clock::now();
+    long long sum1 = 0;
+    for (uint64_t i = 0; i < N; ++i) sum1 += bulk[keys[i]];
+    auto end_single = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl] Sorted lookup via operator[] : "
+        << (end_single - start_single).count() / 1e9 << "s\n";
+
+    std::vector<int> out(N);
+    auto start_many = std::chrono::high_resolution_clock::now();
+    static_cast<const BitmappedBlockSkipList<uint64_t, int>&>(bulk).getMany(keys.data(), N, out.data());
+    long long sum2 = 0;
+    for (uint64_t i = 0; i < N; ++i) sum2 += out[i];
+    auto end_many = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl] Sorted lookup via getMany : "
+        << (end_many - start_many).count() / 1e9 << "s\n";
+
+    assert(sum1 == sum2);
 }
 
 // ============= New: Traversal Performance Comparison Tests =============
@@ -540,7 +2719,7 @@ void test_traversal_performance() {
     // Test 3: Reverse iterator (rbegin/rend)
     start = std::chrono::high_resolution_clock::now();
     long long sum3 = 0;
-    for (auto it = skiplist.rbegin(); it != skiplist.rend(); --it) {
+    for (auto it = skiplist.rbegin(); it != skiplist.rend(); ++it) {
         sum3 += *it;
     }
     end = std::chrono::high_resolution_clock::now();
@@ -557,15 +2736,40 @@ void test_traversal_performance() {
     double time_random = (end - start).count() / 1e9;
     std::cout << "[bsl] Random Access: " << time_random << "s, sum=" << sum4 << std::endl;
 
+    // Test 5: Block-wise reduction
+    start = std::chrono::high_resolution_clock::now();
+    long long sum5 = skiplist.sum<long long>();
+    end = std::chrono::high_resolution_clock::now();
+    double time_sum = (end - start).count() / 1e9;
+    std::cout << "[bsl] sum(): " << time_sum << "s, sum=" << sum5 << std::endl;
+
+    // Test 6: the same scan and lookups after promoting the blocks into extents
+    skiplist.promoteExtents();
+    const auto& promoted = skiplist;
+    start = std::chrono::high_resolution_clock::now();
+    long long sum6 = 0;
+    for (uint64_t i = 0; i < N; ++i) {
+        sum6 += promoted[(i * 7919) % N];
+    }
+    end = std::chrono::high_resolution_clock::now();
+    double time_extent_lookup = (end - start).count() / 1e9;
+    std::cout << "[bsl] extents, strided const lookup: " << time_extent_lookup << "s, sum=" << sum6 << std::endl;
+
+    start = std::chrono::high_resolution_clock::now();
+    long long sum7 = promoted.sum<long long>();
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl] extents, sum(): " << (end - start).count() / 1e9 << "s, sum=" << sum7 << std::endl;
+
     // Summary
     std::cout << "\n--- Performance Summary (forEach as baseline) ---\n";
     std::cout << "forEach:       " << time_forEach << "s (1.00x)\n";
     std::cout << "Iterator:      " << time_iterator << "s (" << (time_iterator / time_forEach) << "x)\n";
     std::cout << "Reverse Iter:  " << time_reverse << "s (" << (time_reverse / time_forEach) << "x)\n";
     std::cout << "Random Access: " << time_random << "s (" << (time_random / time_forEach) << "x)\n";
+    std::cout << "sum():         " << time_sum << "s (" << (time_sum / time_forEach) << "x)\n";
 
     // Verify all sums match
-    assert(sum1 == sum2 && sum2 == sum3 && sum3 == sum4);
+    assert(sum1 == sum2 && sum2 == sum3 && sum3 == sum4 && sum4 == sum5);
 }
 
 void test_sparse_traversal_performance() {
@@ -778,6 +2982,364 @@ void test_hashmap_traversal_performance() {
     assert(sum1 == sum2 && sum2 == sum3);
 }
 
+// ============= New: Prefetch Policy Performance Tests =============
+
+template<typename Options>
+void test_performance_prefetch(uint64_t seed, const char* name) {
+    const uint64_t N = testCount;
+    BitmappedBlockSkipList<uint64_t, int, uint16_t, Options> skiplist(-1);
+
+    // insert in shuffled order so neighbouring blocks do not sit next to each other in the pool
+    std::vector<uint64_t> order(N);
+    for (uint64_t i = 0; i < N; ++i) order[i] = i;
+    std::shuffle(order.begin(), order.end(), std::mt19937_64(seed));
+    for (uint64_t i = 0; i < N; ++i) skiplist[order[i]] = static_cast<int>(order[i]);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    long long sum1 = 0;
+    skiplist.forEach([&sum1](int value, uint64_t) { sum1 += value; });
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "[" << name << "] Scattered forEach: " << (end - start).count() / 1e9 << "s, sum=" << sum1 << std::endl;
+
+    start = std::chrono::high_resolution_clock::now();
+    long long sum2 = 0;
+    const auto& constList = skiplist;
+    for (uint64_t i = 0; i < N; ++i) {
+        sum2 += constList[order[i]];
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "[" << name << "] Scattered random query: " << (end - start).count() / 1e9 << "s, sum=" << sum2 << std::endl;
+
+    assert(sum1 == sum2);
+}
+
+// ============= New: Growth Latency Performance Tests =============
+
+template<typename Options>
+void test_performance_growth_latency(const char* name) {
+    const uint64_t N = testCount;
+    BitmappedBlockSkipList<uint64_t, int, uint16_t, Options> skiplist(-1);
+
+    // one sample per block, so every sample holds one node insert and maybe a level change
+    std::vector<double> samples;
+    samples.reserve(N / 16);
+    for (uint64_t i = 0; i < N; i += 16) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint64_t j = i; j < i + 16; ++j) skiplist[j] = static_cast<int>(j);
+        auto end = std::chrono::high_resolution_clock::now();
+        samples.push_back((end - start).count() / 1e9);
+    }
+
+    // a width moving around a power of 2, one block short of the next level
+    uint64_t blocks = (N + 15) / 16;
+    for (; blocks + 1 < (1ULL << skiplist.getLevel()); ++blocks) skiplist[blocks * 16] = 0;
+    const uint64_t edge = blocks * 16;
+    std::vector<double> edgeSamples;
+    for (uint64_t i = 0; i < 10000; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        skiplist[edge] = 1;
+        skiplist.erase(edge);
+        auto end = std::chrono::high_resolution_clock::now();
+        edgeSamples.push_back((end - start).count() / 1e9);
+    }
+
+    auto report = [name](const char* what, std::vector<double>& values) {
+        std::sort(values.begin(), values.end());
+        std::cout << "[" << name << "] " << what << " p50: " << values[values.size() / 2]
+            << "s, p99: " << values[values.size() * 99 / 100] << "s, max: " << values.back() << "s" << std::endl;
+        };
+    report("Growing insert (16/sample)", samples);
+    report("Insert / erase at a power of 2", edgeSamples);
+}
+
+// ============= New: Persistence Performance Tests =============
+
+void test_performance_persistence() {
+    const uint64_t N = testCount;
+    BitmappedBlockSkipList<uint64_t, int> skiplist(-1);
+    for (uint64_t i = 0; i < N; ++i) skiplist[i * 2] = static_cast<int>(i);
+
+    const char* path = "perf_bbsl.bin";
+    {
+        std::ofstream out(path, std::ios::binary);
+        skiplist.serialize(out);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    BitmappedBlockSkipList<uint64_t, int> rebuilt(-1);
+    for (uint64_t i = 0; i < N; ++i) rebuilt[i * 2] = static_cast<int>(i);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl] Startup through operator[] " << N << " : " << (end - start).count() / 1e9 << "s\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    BitmappedBlockSkipList<uint64_t, int> loaded(-1);
+    {
+        std::ifstream in(path, std::ios::binary);
+        loaded.deserialize(in);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl] Startup through deserialize " << N << " : " << (end - start).count() / 1e9 << "s\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    bbsl::MappedBitmappedBlockSkipList<uint64_t, int> view(-1, path);
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "[mapped] Startup through open " << N << " : " << (end - start).count() / 1e9 << "s\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    long long sum1 = 0;
+    for (uint64_t i = 0; i < N; ++i) sum1 += view[i * 2];
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "[mapped] Query " << N << " : " << (end - start).count() / 1e9 << "s\n";
+
+    long long sum2 = 0;
+    for (uint64_t i = 0; i < N; ++i) sum2 += loaded[i * 2];
+    assert(sum1 == sum2 && loaded.size() == N);
+    std::remove(path);
+}
+
+// ============= New: Frozen Performance Tests =============
+
+void test_performance_frozen(uint64_t seed) {
+    const uint64_t N = testCount;
+    BitmappedBlockSkipList<uint64_t, int> skiplist(-1);
+
+    std::vector<uint64_t> order(N);
+    for (uint64_t i = 0; i < N; ++i) order[i] = i * 3;
+    std::shuffle(order.begin(), order.end(), std::mt19937_64(seed));
+    for (uint64_t i = 0; i < N; ++i) skiplist[order[i]] = static_cast<int>(order[i]);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    const auto frozen = skiplist.freeze();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "[frozen] Freeze " << N << " : " << (end - start).count() / 1e9 << "s\n";
+
+    const auto& constList = skiplist;
+    start = std::chrono::high_resolution_clock::now();
+    long long sum1 = 0;
+    for (uint64_t i = 0; i < N; ++i) sum1 += constList[order[i]];
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl] Scattered random query: " << (end - start).count() / 1e9 << "s\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    long long sum2 = 0;
+    for (uint64_t i = 0; i < N; ++i) sum2 += frozen[order[i]];
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "[frozen] Scattered random query: " << (end - start).count() / 1e9 << "s\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    long long sum3 = 0;
+    skiplist.forEach([&sum3](int value, uint64_t) { sum3 += value; });
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl] Scattered forEach: " << (end - start).count() / 1e9 << "s\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    long long sum4 = 0;
+    frozen.forEach([&sum4](int value, uint64_t) { sum4 += value; });
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "[frozen] forEach: " << (end - start).count() / 1e9 << "s\n";
+
+    assert(sum1 == sum2 && sum2 == sum3 && sum3 == sum4);
+}
+
+void test_performance_snapshot() {
+    const uint64_t N = testCount;
+    BitmappedBlockSkipList<uint64_t, int, uint16_t, SnapshotOptions> skiplist(-1);
+    for (uint64_t i = 0; i < N; ++i) skiplist[i] = static_cast<int>(i);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto copy = skiplist;
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl] Copy " << N << " : " << (end - start).count() / 1e9 << "s\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    auto snap = skiplist.snapshot();
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "[snapshot] Take " << N << " : " << (end - start).count() / 1e9 << "s\n";
+
+    // the first write to a block copies it, the later ones do not
+    start = std::chrono::high_resolution_clock::now();
+    for (uint64_t i = 0; i < N; ++i) skiplist[i] = 1;
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "[snapshot] Overwrite all while shared: " << (end - start).count() / 1e9 << "s\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    for (uint64_t i = 0; i < N; ++i) skiplist[i] = 2;
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "[snapshot] Overwrite all again: " << (end - start).count() / 1e9 << "s\n";
+
+    long long sum1 = 0, sum2 = 0;
+    snap.forEach([&sum1](int value, uint64_t) { sum1 += value; });
+    copy.forEach([&sum2](int value, uint64_t) { sum2 += value; });
+    assert(sum1 == sum2);
+}
+
+void test_performance_parallel() {
+    const uint64_t N = testCount * 16;
+    BitmappedBlockSkipList<uint64_t, int64_t> skiplist(-1);
+    for (uint64_t i = 0; i < N; ++i) skiplist[i] = static_cast<int64_t>(i & 1023);
+    const auto add = [](int64_t a, int64_t b) { return a + b; };
+    std::cout << "Data: " << N << " dense elements, " << bbsl::ThreadExecutor().concurrency() << " hardware threads\n";
+
+    auto start = std::chrono::high_resolution_clock::now();
+    const int64_t sum1 = skiplist.reduce(int64_t(0), add);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl] reduce: " << (end - start).count() / 1e9 << "s\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    const int64_t sum2 = skiplist.parallelReduce(int64_t(0), add);
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl] parallelReduce: " << (end - start).count() / 1e9 << "s\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    bool found1 = skiplist.some([](int64_t value, uint64_t) { return value < 0; });
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl] some (no hit): " << (end - start).count() / 1e9 << "s\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    bool found2 = skiplist.parallelSome([](int64_t value, uint64_t) { return value < 0; });
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl] parallelSome (no hit): " << (end - start).count() / 1e9 << "s\n";
+
+    assert(sum1 == sum2 && !found1 && !found2);
+}
+
+void test_performance_shift() {
+    const uint64_t N = testCount / 10;
+    const uint64_t shifts = 1000;
+    BitmappedBlockSkipList<uint64_t, int> skiplist(-1);
+    for (uint64_t i = 0; i < N; ++i) skiplist[i] = static_cast<int>(i);
+    BitmappedBlockSkipList<uint64_t, int> naive(skiplist);
+
+    // Array.prototype.shift by renumbering the blocks
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint64_t s = 0; s < shifts; ++s) skiplist.shiftIndices(1, -1);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl] " << shifts << " shifts of " << N << " by shiftIndices: " << (end - start).count() / 1e9 << "s\n";
+
+    // the same by moving every element
+    const uint64_t naiveShifts = 10;
+    start = std::chrono::high_resolution_clock::now();
+    for (uint64_t s = 0; s < naiveShifts; ++s) {
+        const uint64_t count = naive.size();
+        for (uint64_t i = 0; i + 1 < count; ++i) naive[i] = naive[i + 1];
+        naive.erase(count - 1);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl] " << naiveShifts << " shifts of " << N << " by operator[] / erase: " << (end - start).count() / 1e9 << "s\n";
+
+    assert(skiplist[0] == static_cast<int>(shifts) && naive[0] == static_cast<int>(naiveShifts));
+}
+
+void test_performance_order_statistics() {
+    const uint64_t N = testCount;
+    const uint64_t queries = 100000;
+    BitmappedBlockSkipList<uint64_t, int, uint16_t, OrderStatisticOptions> counted(-1);
+    BitmappedBlockSkipList<uint64_t, int> plain(-1);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint64_t i = 0; i < N; ++i) counted[i * 2] = static_cast<int>(i);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl order statistics] Insert " << N << " elements took: " << (end - start).count() / 1e9 << "s\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    for (uint64_t i = 0; i < N; ++i) plain[i * 2] = static_cast<int>(i);
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl] Insert " << N << " elements took: " << (end - start).count() / 1e9 << "s\n";
+
+    std::mt19937_64 rng(28);
+    uint64_t sum = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (uint64_t q = 0; q < queries; ++q) sum += counted.rank((rng() % N) * 2) + *counted.nth(rng() % N);
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl order statistics] " << queries << " rank + nth: " << (end - start).count() / 1e9 << "s\n";
+
+    // the level 0 walk, a few queries are enough
+    const uint64_t walks = 100;
+    uint64_t walked = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (uint64_t q = 0; q < walks; ++q) walked += plain.rank((rng() % N) * 2) + *plain.nth(rng() % N);
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl] " << walks << " rank + nth: " << (end - start).count() / 1e9 << "s\n";
+
+    assert(sum != 0 && walked != 0);
+}
+
+void test_performance_set_algebra() {
+    const uint64_t N = testCount;
+    BitmappedBlockSkipList<uint64_t, int> a(-1), b(-1);
+    for (uint64_t i = 0; i < N; ++i) {
+        if (i % 3 != 0) a[i] = static_cast<int>(i);
+        if (i % 2 != 0) b[i] = static_cast<int>(i);
+    }
+
+    BitmappedBlockSkipList<uint64_t, int> blockwise(a), naive(a);
+    auto start = std::chrono::high_resolution_clock::now();
+    blockwise.intersectKeys(b);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl] intersectKeys of " << N << " keys: " << (end - start).count() / 1e9 << "s\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    std::vector<uint64_t> drop;
+    naive.forEach([&b, &drop](int, uint64_t index) {
+        if (!b.has(index)) drop.push_back(index);
+        });
+    naive.eraseMany(drop.data(), drop.size());
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl] intersect by has / eraseMany: " << (end - start).count() / 1e9 << "s\n";
+    assert(blockwise.size() == naive.size());
+
+    BitmappedBlockSkipList<uint64_t, int> merged(a), naiveMerged(a);
+    start = std::chrono::high_resolution_clock::now();
+    merged.unionWith(b, [](int mine, int theirs) { return mine + theirs; });
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl] unionWith of " << N << " keys: " << (end - start).count() / 1e9 << "s\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    b.forEach([&naiveMerged](int value, uint64_t index) {
+        if (naiveMerged.has(index)) naiveMerged[index] += value;
+        else naiveMerged[index] = value;
+        });
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl] union by has / operator[]: " << (end - start).count() / 1e9 << "s\n";
+    assert(merged.size() == naiveMerged.size());
+}
+
+void test_performance_lifetime() {
+    const uint64_t N = testCount;
+    auto value = std::make_shared<int>(1);
+
+    // refcounted values stored in the blocks
+    auto start = std::chrono::high_resolution_clock::now();
+    {
+        BitmappedBlockSkipList<uint64_t, std::shared_ptr<int>> list(nullptr);
+        for (uint64_t i = 0; i < N; ++i) list.emplace(i, value);
+        uint64_t sum = 0;
+        list.forEach([&sum](const std::shared_ptr<int>& element, uint64_t) { sum += *element; });
+        list.eraseRange(0, N / 2);
+        assert(sum == N && value.use_count() == static_cast<long>(N / 2) + 1);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl shared_ptr] emplace / scan / eraseRange / destroy " << N << ": " << (end - start).count() / 1e9 << "s\n";
+
+    // the same with slots into a side table
+    start = std::chrono::high_resolution_clock::now();
+    {
+        BitmappedBlockSkipList<uint64_t, uint32_t> list(~0U);
+        std::vector<std::shared_ptr<int>> table;
+        for (uint64_t i = 0; i < N; ++i) {
+            list[i] = static_cast<uint32_t>(table.size());
+            table.push_back(value);
+        }
+        uint64_t sum = 0;
+        list.forEach([&sum, &table](uint32_t slot, uint64_t) { sum += *table[slot]; });
+        list.forEachInRange(0, N / 2, [&table](uint32_t slot, uint64_t) { table[slot].reset(); });
+        list.eraseRange(0, N / 2);
+        assert(sum == N && value.use_count() == static_cast<long>(N / 2) + 1);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "[bsl side table] insert / scan / eraseRange / destroy " << N << ": " << (end - start).count() / 1e9 << "s\n";
+}
+
 int main() {
     std::cout << "Starting data structure `BBSL` benchmark test" << std::endl;
 #ifndef NDEBUG
@@ -791,6 +3353,35 @@ int main() {
     test2();
     test3();
     test4();
+    test5();
+    test6();
+    test7();
+    test8();
+    test9();
+    test10();
+    test11();
+    test12();
+    test13();
+    test14();
+    test15();
+    test16();
+    test17();
+    test18();
+    test19();
+    test20();
+    test21();
+    test22();
+    test23();
+    test24();
+    test25();
+    test26();
+    test27();
+    test28();
+    test29();
+    test30();
+    test31();
+    test32();
+    test33();
 
     // Generate random seeds using system time and other sources
     auto now = std::chrono::high_resolution_clock::now();
@@ -813,6 +3404,7 @@ int main() {
     std::cout << "\n========== New: Zipf Distribution (Realistic Scenario) ==========\n";
     test_performance_zipf_stdmap(seedA);
     test_performance_zipf_bsl(seedA);
+    test_performance_zipf_bsl<IndexCacheOptions>(seedA, "bsl index cache");
 
     std::cout << "\n========== New: Range Query Performance Tests ==========\n";
     test_performance_range_stdmap();
@@ -822,6 +3414,38 @@ int main() {
     test_performance_batch_stdmap();
     test_performance_batch_bsl();
 
+    std::cout << "\n========== New: Prefetch Policy Performance Tests ==========\n";
+    test_performance_prefetch<DefaultOptions>(seedA, "bsl");
+    test_performance_prefetch<PrefetchOptions>(seedA, "bsl prefetch");
+
+    std::cout << "\n========== New: Growth Latency Performance Tests ==========\n";
+    test_performance_growth_latency<DefaultOptions>("bsl");
+    test_performance_growth_latency<IndexedLevelOptions>("bsl indexed levels");
+
+    std::cout << "\n========== New: Persistence Performance Tests ==========\n";
+    test_performance_persistence();
+
+    std::cout << "\n========== New: Frozen Performance Tests ==========\n";
+    test_performance_frozen(seedA);
+
+    std::cout << "\n========== New: Snapshot Performance Tests ==========\n";
+    test_performance_snapshot();
+
+    std::cout << "\n========== New: Parallel Traversal Performance Tests ==========\n";
+    test_performance_parallel();
+
+    std::cout << "\n========== New: Index Shift Performance Tests ==========\n";
+    test_performance_shift();
+
+    std::cout << "\n========== New: Order Statistic Performance Tests ==========\n";
+    test_performance_order_statistics();
+
+    std::cout << "\n========== New: Set Algebra Performance Tests ==========\n";
+    test_performance_set_algebra();
+
+    std::cout << "\n========== New: Value Lifetime Performance Tests ==========\n";
+    test_performance_lifetime();
+
     std::cout << "\n========== New: traversal Performance Tests ==========\n";
     test_traversal_performance();
     test_sparse_traversal_performance();